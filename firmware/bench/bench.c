@@ -0,0 +1,88 @@
+/*--------------------------------------------------------------------------*
+* Library benchmarks
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Benchmark firmware for the shared library. Each BENCH() region is timed
+* by simbench using the simulator cycle counter. Run with 'make bench'.
+*--------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include "../hardware.h"
+#include "softuart.h"
+#include "iohelp.h"
+#include "utility.h"
+#include "systicks.h"
+#include "nokialcd.h"
+#include "fixmath.h"
+#include "bench.h"
+
+// The ticks interrupt handler (called directly)
+void TICKS_vect(void);
+
+//! Results are stored here so the calls are not optimised away
+static volatile uint16_t g_result;
+
+/** Program entry point
+ */
+int main() {
+  // Cost of the markers alone
+  for(uint8_t count=0; count<4; count++)
+    BENCH(BENCH_OVERHEAD, );
+  // UART output
+  uartInit();
+  BENCH("uartSend", uartSend('U'));
+  BENCH("uartInt(0)", uartInt(0));
+  BENCH("uartInt(9)", uartInt(9));
+  BENCH("uartInt(12345)", uartInt(12345));
+  BENCH("uartInt(65535)", uartInt(65535));
+  BENCH("uartHex", uartHex(0xBEEF));
+  BENCH("uartFormatP", uartFormatP(PSTR("%u/%x\n"), 1234, 0x5678));
+  // CRC calculation
+  uint16_t crc = crcInit();
+  for(uint8_t data=0; data<16; data++)
+    BENCH("crcByte", crc = crcByte(crc, data * 17));
+  g_result = crc;
+  // Fixed point maths (values are volatile so nothing is precalculated)
+  static volatile uint16_t value = 54321;
+  static volatile uint32_t value32 = 987654321UL;
+  BENCH("fixMul8", g_result = fixMul8(value, value >> 8));
+  BENCH("fixMul16", g_result = fixMul16(value, value) >> 16);
+  BENCH("mul16 (libgcc)", g_result = ((uint32_t)value * value) >> 16);
+  BENCH("fixMulConst(5000)", g_result = fixMulConst(value, 5000) >> 10);
+  BENCH("fixDivConst(10)", g_result = fixDivConst(value, 10));
+  BENCH("div10 (libgcc)", g_result = value / 10);
+  BENCH("fixSqrt16", g_result = fixSqrt16(value));
+  BENCH("fixSqrt32", g_result = fixSqrt32(value32));
+  BENCH("fixSin", g_result = fixSin(value));
+  BENCH("fixLog2", g_result = fixLog2(value));
+#ifdef __AVR_ATtiny85__
+  // Analog input (analog.c is only built for the ATtiny85)
+  adcInit(ADC1);
+  BENCH("adcRead(1 sample)", g_result = adcRead(ADC1, 0, 1));
+  BENCH("adcRead(4 samples)", g_result = adcRead(ADC1, 0, 4));
+#endif
+  // Software PWM and system ticks interrupt handler
+  spwmInit();
+  spwmOut(SPWM0, 64);
+  spwmOut(SPWM1, 128);
+  spwmOut(SPWM2, 255);
+  for(uint8_t count=0; count<64; count++)
+    BENCH("TICKS_vect", cli(); TICKS_vect());
+  cli();
+#ifdef LCD_ENABLED
+  // LCD output
+  lcdInit();
+  BENCH("lcdData", lcdData(0x55));
+  BENCH("lcdPrintChar", lcdPrintChar(0, 0, 'A', false));
+  BENCH("lcdPrint(14 chars)", lcdPrint(1, 0, "Hello, World!!", false));
+  BENCH("lcdClearRow", lcdClearRow(2, false));
+#endif
+  // Sleeping with interrupts disabled ends the simulation
+  sleep_enable();
+  sleep_cpu();
+  return 0;
+  }
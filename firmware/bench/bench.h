@@ -0,0 +1,79 @@
+/*--------------------------------------------------------------------------*
+* Benchmark support
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Markers used by benchmark firmware to delimit the code being measured.
+* The firmware is run under simavr by 'simbench' which watches writes to
+* two otherwise unused registers and records the simulator cycle count at
+* the start and end of each region.
+*--------------------------------------------------------------------------*/
+#ifndef __BENCH_H
+#define __BENCH_H
+
+//--- Required definitions
+#include <stdint.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+
+/** Data space addresses of the marker registers
+ *
+ * The general purpose IO registers where the chip has them. The ATmega8
+ * has none so the EEPROM data and address registers are used instead (the
+ * benchmarks do not use the EEPROM). The Makefile reads these values and
+ * passes them to simbench.
+ */
+#if defined(__AVR_ATmega8__)
+#  define BENCH_MARK_ADDR 0x3D // EEDR
+#  define BENCH_NAME_ADDR 0x3E // EEARL
+#elif defined(__AVR_ATmega88__) || defined(__AVR_ATmega168__)
+#  define BENCH_MARK_ADDR 0x3E // GPIOR0
+#  define BENCH_NAME_ADDR 0x4A // GPIOR1
+#else
+#  define BENCH_MARK_ADDR 0x31 // GPIOR0
+#  define BENCH_NAME_ADDR 0x32 // GPIOR1
+#endif
+
+/** Register used to mark the start (1) and end (0) of a measured region */
+#define BENCH_MARK _SFR_MEM8(BENCH_MARK_ADDR)
+
+/** Register used to send the name of the next region (nul terminated) */
+#define BENCH_NAME _SFR_MEM8(BENCH_NAME_ADDR)
+
+/** Name of the region used to measure the cost of the markers themselves */
+#define BENCH_OVERHEAD "_overhead"
+
+/** Send the name of the next region to the simulator
+ *
+ * @param name pointer to the nul terminated name in PROGMEM.
+ */
+static inline void benchName(const char *name) {
+  char ch;
+  do {
+    ch = pgm_read_byte_near(name++);
+    BENCH_NAME = ch;
+    }
+  while(ch!='\0');
+  }
+
+/** Measure a single piece of code
+ *
+ * The region name is sent first (outside the measurement), then the code is
+ * run between the start and end markers. Each use of the macro produces a
+ * single sample for the named region, simbench reports the count, minimum,
+ * maximum and average cycles for each name.
+ *
+ * @param name the name of the region (a string literal).
+ * @param code the code to measure.
+ */
+#define BENCH(name, code) \
+  do { \
+    benchName(PSTR(name)); \
+    asm volatile("" ::: "memory"); \
+    BENCH_MARK = 1; \
+    code; \
+    BENCH_MARK = 0; \
+    asm volatile("" ::: "memory"); \
+    } while(0)
+
+#endif /* __BENCH_H */
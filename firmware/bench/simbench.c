@@ -0,0 +1,174 @@
+/*--------------------------------------------------------------------------*
+* Benchmark runner for simavr
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Runs a benchmark firmware (see bench.h) under simavr and reports the
+* number of cycles used by each named region as JSON on stdout. Build with
+* 'make bench' which requires simavr and libelf to be installed.
+*
+* Usage: simbench [-m mcu] [-f frequency] [-a mark,name] firmware.elf
+*
+* The -a option gives the data space addresses of the marker registers
+* (BENCH_MARK_ADDR and BENCH_NAME_ADDR in bench.h) in hex, eg: 0x3E,0x4A.
+* The default is the ATtiny85 general purpose IO registers.
+*--------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sim_avr.h>
+#include <sim_elf.h>
+#include <sim_io.h>
+
+// Default data space addresses of the marker registers (ATtiny85 GPIOR0
+// and GPIOR1)
+#define BENCH_MARK_ADDR 0x31
+#define BENCH_NAME_ADDR 0x32
+
+// Limits
+#define MAX_NAME    64
+#define MAX_RESULTS 128
+
+// Name of the region used to measure marker overhead
+#define BENCH_OVERHEAD "_overhead"
+
+/** Results for a single named region
+ */
+typedef struct _RESULT {
+  char     name[MAX_NAME];
+  uint32_t count;
+  uint64_t total;
+  uint64_t min;
+  uint64_t max;
+  } RESULT;
+
+//! All results collected so far
+static RESULT g_results[MAX_RESULTS];
+static int g_count = 0;
+
+//! Name of the next region
+static char g_name[MAX_NAME];
+static int g_nameLength = 0;
+
+//! Cycle count at the start of the current region
+static avr_cycle_count_t g_start = 0;
+
+/** Find (or create) the result entry for a name
+ */
+static RESULT *findResult(const char *name) {
+  for(int index=0; index<g_count; index++) {
+    if(strcmp(g_results[index].name, name)==0)
+      return &g_results[index];
+    }
+  if(g_count==MAX_RESULTS)
+    return NULL;
+  RESULT *result = &g_results[g_count++];
+  memset(result, 0, sizeof(RESULT));
+  strncpy(result->name, name, MAX_NAME - 1);
+  result->min = UINT64_MAX;
+  return result;
+  }
+
+/** Handle writes to the name register
+ */
+static void onName(avr_t *avr, avr_io_addr_t addr, uint8_t value, void *param) {
+  if(value==0) {
+    g_name[g_nameLength] = '\0';
+    g_nameLength = 0;
+    }
+  else if(g_nameLength<(MAX_NAME - 1))
+    g_name[g_nameLength++] = value;
+  }
+
+/** Handle writes to the marker register
+ */
+static void onMark(avr_t *avr, avr_io_addr_t addr, uint8_t value, void *param) {
+  if(value) {
+    g_start = avr->cycle;
+    return;
+    }
+  RESULT *result = findResult(g_name);
+  if(result==NULL)
+    return;
+  uint64_t cycles = avr->cycle - g_start;
+  result->count++;
+  result->total += cycles;
+  if(cycles<result->min)
+    result->min = cycles;
+  if(cycles>result->max)
+    result->max = cycles;
+  }
+
+/** Program entry point
+ */
+int main(int argc, char *argv[]) {
+  const char *mcu = "attiny85";
+  uint32_t frequency = 8000000;
+  unsigned markAddr = BENCH_MARK_ADDR, nameAddr = BENCH_NAME_ADDR;
+  int opt;
+  while((opt = getopt(argc, argv, "m:f:a:"))!=-1) {
+    if(opt=='m')
+      mcu = optarg;
+    else if(opt=='f')
+      frequency = strtoul(optarg, NULL, 0);
+    else if((opt=='a')&&(sscanf(optarg, "%x,%x", &markAddr, &nameAddr)==2))
+      continue;
+    else {
+      fprintf(stderr, "Usage: %s [-m mcu] [-f frequency] [-a mark,name] firmware.elf\n", argv[0]);
+      return 1;
+      }
+    }
+  if(optind>=argc) {
+    fprintf(stderr, "Usage: %s [-m mcu] [-f frequency] [-a mark,name] firmware.elf\n", argv[0]);
+    return 1;
+    }
+  // Load the firmware
+  elf_firmware_t firmware;
+  memset(&firmware, 0, sizeof(firmware));
+  if(elf_read_firmware(argv[optind], &firmware)!=0) {
+    fprintf(stderr, "ERROR: Unable to load '%s'\n", argv[optind]);
+    return 1;
+    }
+  avr_t *avr = avr_make_mcu_by_name(mcu);
+  if(avr==NULL) {
+    fprintf(stderr, "ERROR: Unknown MCU '%s'\n", mcu);
+    return 1;
+    }
+  avr_init(avr);
+  avr_load_firmware(avr, &firmware);
+  avr->frequency = frequency;
+  avr_register_io_write(avr, markAddr, onMark, NULL);
+  avr_register_io_write(avr, nameAddr, onName, NULL);
+  // Run until the firmware sleeps with interrupts disabled
+  int state = cpu_Running;
+  while((state!=cpu_Done)&&(state!=cpu_Crashed))
+    state = avr_run(avr);
+  if(state==cpu_Crashed) {
+    fprintf(stderr, "ERROR: Firmware crashed at cycle %llu\n", (unsigned long long)avr->cycle);
+    return 1;
+    }
+  // Marker overhead is subtracted from all other results
+  uint64_t overhead = 0;
+  for(int index=0; index<g_count; index++) {
+    if(strcmp(g_results[index].name, BENCH_OVERHEAD)==0)
+      overhead = g_results[index].min;
+    }
+  // Generate the report
+  printf("{\n  \"mcu\": \"%s\",\n  \"f_cpu\": %u,\n  \"overhead\": %llu,\n  \"results\": [", mcu, frequency, (unsigned long long)overhead);
+  const char *separator = "\n";
+  for(int index=0; index<g_count; index++) {
+    RESULT *result = &g_results[index];
+    if(strcmp(result->name, BENCH_OVERHEAD)==0)
+      continue;
+    printf("%s    { \"name\": \"%s\", \"count\": %u, \"min\": %llu, \"max\": %llu, \"avg\": %.1f }",
+      separator, result->name, result->count,
+      (unsigned long long)(result->min - overhead),
+      (unsigned long long)(result->max - overhead),
+      ((double)result->total / result->count) - overhead);
+    separator = ",\n";
+    }
+  printf("\n    ]\n  }\n");
+  return 0;
+  }
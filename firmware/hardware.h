@@ -24,6 +24,8 @@
  * This feature provides a software implementation of a UART allowing you to
  * perform serial communications. It supports speeds of up to 250Kbps, can be
  * configured to use a single IO pin and has an option to be interrupt driven.
+ * On the ATmega parts the hardware USART is used instead with the same API
+ * (see usart.c) at up to 1Mbps.
  */
 #define UART_ENABLED
 
@@ -50,8 +52,18 @@
  * The implementation is optimised for higher baudrates - please don't use
  * anything below 57600 on an 8MHz clock. It does work at up to 250000 baud
  * but you may experience a small amount of dropped packets at that speed.
+ * The limits scale with the clock profile (500000 baud at 16MHz), the 1MHz
+ * profile defaults to 9600 baud. The hardware USART on the ATmega parts
+ * cannot get within 2% of 57600 baud at 8MHz so it uses 38400 there.
  */
-#define BAUD_RATE 57600
+#if F_CPU < 4000000
+#  define BAUD_RATE 9600
+#elif (F_CPU < 16000000) && \
+  (defined(__AVR_ATmega8__) || defined(__AVR_ATmega88__) || defined(__AVR_ATmega168__))
+#  define BAUD_RATE 38400
+#else
+#  define BAUD_RATE 57600
+#endif
 
 /** Define the pin to use for transmission
  */
@@ -75,10 +87,135 @@
 /** Size of input buffer
  *
  * Only available in interrupt driven mode. This sets the size of the receive
- * buffer (max 256 bytes).
+ * buffer (max 256 bytes). For the hardware USART this must be a power of two
+ * and the buffer holds one less than this number of characters.
  */
 #define UART_BUFFER 4
 
+/** Size of the transmit buffer for the hardware USART
+ *
+ * Only used on the ATmega parts. Must be a power of two, the buffer holds
+ * one less than this number of characters. uartSend() waits for room when
+ * the buffer is full.
+ */
+#define UART_TX_BUFFER 16
+
+//---------------------------------------------------------------------------
+// Pin change interrupts and input events
+//
+// The dispatcher takes over PCINT0_vect and calls a handler for each pin
+// that changes. If the UART is interrupt driven it is serviced first. The
+// debounced input events are sampled every system tick (requires the
+// system ticks to be running).
+//---------------------------------------------------------------------------
+
+// Enable the pin change dispatcher
+//#define PCINT_ENABLED
+
+// Enable debounced input events
+//#define INPUT_ENABLED
+
+/** Number of input events that can be queued
+ *
+ * Must be a power of two. The queue holds one less than this number of
+ * events, further events are dropped until inputNext() makes room.
+ */
+#define INPUT_QUEUE 8
+
+//---------------------------------------------------------------------------
+// Cooperative tasks
+//
+// The task macros in task.h can be used on their own, this enables the
+// taskRun() scheduler. Each task needs 4 bytes of RAM for its state and
+// all tasks share the main stack.
+//---------------------------------------------------------------------------
+
+// Enable the task scheduler
+//#define TASK_ENABLED
+
+/** Sleep when every task is waiting
+ *
+ * Puts the CPU in idle mode until the next interrupt when a pass of the
+ * scheduler finds nothing to do. Requires the system ticks to be running
+ * (the scheduler does not sleep otherwise) so polled conditions are
+ * checked at least once per timer overflow.
+ */
+#define TASK_IDLE_SLEEP
+
+//---------------------------------------------------------------------------
+// Second software UART
+//
+// An additional two pin, interrupt driven UART with its own pins, baud rate
+// and receive buffer (uart1Init(), uart1Send(), uart1Avail() and
+// uart1Recv()). Requires PCINT_ENABLED, both channels share the pin change
+// interrupt.
+//
+// The receive code holds the CPU for about 9.5 bit times per byte (165us
+// at 57600 baud) and transmitting disables interrupts for 10 bit times, so
+// only one channel can be busy at any moment. A start bit arriving on one
+// channel while the other is sending or receiving loses or corrupts that
+// byte. A receive on the second channel starts about 60 cycles (7.5us at
+// 8MHz) after the edge when the main UART is interrupt driven, 48 cycles
+// when it is not, or up to a full byte later if the main UART is
+// receiving. The combined throughput is at best that of a single channel,
+// so use request/response exchanges or low duty cycle traffic (a GPS
+// module sending once a second beside a command console works well).
+//---------------------------------------------------------------------------
+
+// Enable the second UART
+//#define UART1_ENABLED
+
+/** Baud rate for the second UART
+ *
+ * The 8 bit delay loops limit this to 20833 baud or more on an 8MHz clock.
+ */
+#define UART1_BAUD_RATE 38400
+
+/** Transmit pin for the second UART
+ */
+#define UART1_TX PINB3
+
+/** Receive pin for the second UART (must differ from UART1_TX)
+ */
+#define UART1_RX PINB4
+
+/** Size of the receive buffer for the second UART (max 256 bytes)
+ */
+#define UART1_BUFFER 4
+
+//---------------------------------------------------------------------------
+// Packet protocol
+//
+// Binary packets over the software UART, COBS framed with a CRC16. See
+// packet.h for the format and tools/packet.py for the host side.
+//---------------------------------------------------------------------------
+
+// Enable the packet protocol
+//#define PACKET_ENABLED
+
+/** Largest packet payload that can be received (max 253 bytes)
+ */
+#ifndef PACKET_SIZE
+#  define PACKET_SIZE 32
+#endif
+
+//---------------------------------------------------------------------------
+// Multi-drop bus
+//
+// Many nodes sharing a single wire using the one pin UART (UART_TX and
+// UART_RX the same). The line must be open drain with a pull up resistor,
+// nodes only ever drive it low. Frames are packets (see packet.h) with an
+// address byte in front and nodes only buffer frames sent to their own
+// address or to BUS_BROADCAST. Requires PACKET_ENABLED and UART_INTERRUPT.
+//---------------------------------------------------------------------------
+
+// Enable the multi-drop bus
+//#define BUS_ENABLED
+
+/** Number of times to try sending a frame when collisions occur
+ */
+#define BUS_RETRIES 8
+
 //---------------------------------------------------------------------------
 // Software PWM configuration
 //---------------------------------------------------------------------------
@@ -102,6 +239,119 @@
 /** Pin associated with SPWM3 */
 #define SPWM_PIN3 PINB3
 
+//---------------------------------------------------------------------------
+// Profiler configuration
+//
+// The profiler is only included when PROFILE is defined (build with
+// 'make PROFILE=1'). It uses the system ticks timer for time stamps.
+//---------------------------------------------------------------------------
+
+/** Number of regions that can be profiled
+ *
+ * Each region uses 12 bytes of RAM.
+ */
+#define PROFILE_REGIONS 8
+
+//---------------------------------------------------------------------------
+// Event trace configuration
+//
+// Records from TRACE() are time stamped with the system ticks timer and
+// kept in a RAM ring buffer until traceDrain() sends them over the UART.
+// Use tools/tracedump.py to display them.
+//---------------------------------------------------------------------------
+
+// Enable event tracing
+//#define TRACE_ENABLED
+
+/** Number of records in the trace buffer
+ *
+ * Must be a power of two. Each record uses 4 bytes of RAM and the buffer
+ * holds one less than this number of records.
+ */
+#define TRACE_RECORDS 32
+
+//---------------------------------------------------------------------------
+// Latency instrumentation
+//
+// Records the longest time interrupts are disabled by the library and the
+// longest time spent in a library interrupt handler. Measurements use the
+// system ticks timer count (TIMER1, TIMER2 on the ATmega parts) and the
+// first compare unit of that timer so the system ticks must be running and
+// the compare unit cannot be used for anything else. See latency.h
+//---------------------------------------------------------------------------
+
+// Enable latency instrumentation
+//#define LATENCY_ENABLED
+
+//---------------------------------------------------------------------------
+// Stack usage measurement
+//
+// Fills unused RAM with a known value at startup so ramHighWater() can
+// report how deep the stack has grown. Use 'make stack' for a static
+// estimate of the stack needed by main() and each interrupt handler.
+//---------------------------------------------------------------------------
+
+// Enable stack painting and ramHighWater()
+//#define STACK_CHECK_ENABLED
+
+//---------------------------------------------------------------------------
+// EEPROM key/value store configuration
+//
+// Values are appended to a circular log in EEPROM so every write goes to a
+// different location. Each record uses KV_VALUE_SIZE + 4 bytes of EEPROM.
+// A copy of every value is kept in RAM (KV_KEYS * (KV_VALUE_SIZE + 1) bytes)
+// and writes are done in the background by the EEPROM ready interrupt.
+//---------------------------------------------------------------------------
+
+// Enable the key/value store
+//#define KV_ENABLED
+
+/** Number of keys (keys are numbered from 0 to KV_KEYS - 1) */
+#define KV_KEYS 8
+
+/** Size of each value in bytes */
+#define KV_VALUE_SIZE 4
+
+/** First EEPROM address used by the store */
+#define KV_EEPROM_START 0
+
+/** Number of bytes of EEPROM used by the store */
+#define KV_EEPROM_SIZE 512
+
+//---------------------------------------------------------------------------
+// I2C (TWI) master configuration
+//
+// The I2C master uses the USI module so the pins are fixed - SDA is PB0 and
+// SCL is PB2. Both lines need external pull up resistors.
+//---------------------------------------------------------------------------
+
+/** Bus speed
+ *
+ * Either 100000 (standard mode) or 400000 (fast mode). This only sets the
+ * minimum bus timing, slaves may still stretch the clock.
+ */
+#define TWI_SPEED 100000
+
+//---------------------------------------------------------------------------
+// I2C (TWI) slave configuration
+//
+// The slave also uses the USI module (SDA is PB0, SCL is PB2) so it cannot
+// be used at the same time as the I2C master. It presents a block of RAM
+// registers to the bus master - the first byte of a write sets the register
+// pointer, following bytes are written to the registers and reads return
+// the registers starting at the pointer. The pointer auto increments and
+// wraps around at the end of the register block.
+//---------------------------------------------------------------------------
+
+// Enable I2C slave support
+//#define TWI_SLAVE_ENABLED
+
+/** Slave address (7 bit) */
+#define TWI_SLAVE_ADDRESS 0x20
+
+/** Number of registers to provide (max 256) */
+#define TWI_SLAVE_REGISTERS 8
+
 //---------------------------------------------------------------------------
 // Nokia LCD device support
 //
@@ -118,4 +368,42 @@
 #define LCD_CD    PINB1
 #define LCD_RESET PINB0
 
+// Enable the banded frame buffer (requires LCD_ENABLED)
+//#define LCD_BAND_ENABLED
+
+// Number of 8 pixel rows held in the frame buffer band (1 or 2). Each row
+// costs 95 bytes of RAM (84 bytes of pixel data and an 11 byte dirty map).
+#define LCD_BAND_ROWS 1
+
+//---------------------------------------------------------------------------
+// SSD1306 OLED device support
+//
+// To use this device uncomment the OLED_ENABLED line below and define your
+// pins with the OLED_xxx defines
+//---------------------------------------------------------------------------
+
+// Enable SSD1306 OLED support
+//#define OLED_ENABLED
+
+// I2C address of the display (0x3C or 0x3D depending on the module)
+#define OLED_ADDRESS 0x3C
+
+// SSD1306 OLED pin numbers (both lines need pull up resistors)
+#define OLED_SDA  PINB0
+#define OLED_SCL  PINB2
+
+//---------------------------------------------------------------------------
+// WS2812 / SK6812 LED strip support
+//
+// To use this device uncomment the WS2812_ENABLED line below and set the
+// data pin. The driver is cycle counted for an 8MHz or 16MHz clock and
+// runs with interrupts disabled (10us per LED at 800kHz).
+//---------------------------------------------------------------------------
+
+// Enable WS2812 LED strip support
+//#define WS2812_ENABLED
+
+// WS2812 data pin
+#define WS2812_PIN PINB1
+
 #endif /* __HARDWARE_H */
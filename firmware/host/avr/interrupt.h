@@ -0,0 +1,41 @@
+/*--------------------------------------------------------------------------*
+* Interrupt support for host builds
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Replaces <avr/interrupt.h> when building on the host. Interrupt handlers
+* become plain functions named after the vector which the mock calls when
+* the interrupt is triggered.
+*--------------------------------------------------------------------------*/
+#ifndef __MOCK_AVR_INTERRUPT_H
+#define __MOCK_AVR_INTERRUPT_H
+
+#include <avr/io.h>
+
+#define sei() mockSei()
+#define cli() mockCli()
+
+#define ISR(vector, ...) \
+  void vector(void); \
+  void vector(void)
+
+#define EMPTY_INTERRUPT(vector) \
+  void vector(void) { }
+
+#define ISR_BLOCK
+#define ISR_NOBLOCK
+#define ISR_NAKED
+
+//--- Vectors called by the mock
+void INT0_vect(void);
+void PCINT0_vect(void);
+void TIMER1_COMPA_vect(void);
+void TIMER1_OVF_vect(void);
+void TIMER0_OVF_vect(void);
+void EE_RDY_vect(void);
+void ADC_vect(void);
+void TIMER0_COMPA_vect(void);
+void USI_START_vect(void);
+void USI_OVF_vect(void);
+
+#endif /* __MOCK_AVR_INTERRUPT_H */
@@ -0,0 +1,265 @@
+/*--------------------------------------------------------------------------*
+* ATtiny85 register definitions for host builds
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Replaces <avr/io.h> when building on the host. Registers are mapped on to
+* the storage provided by the mock (see mockio.h), bit numbers match the
+* ATtiny85 data sheet.
+*--------------------------------------------------------------------------*/
+#ifndef __MOCK_AVR_IO_H
+#define __MOCK_AVR_IO_H
+
+#include <stdint.h>
+#include "mockio.h"
+
+//--- Register access
+#define MOCK_REG(reg)    (*mockRegister(reg))
+#define _BV(bit)         (1 << (bit))
+#define _SFR_IO_ADDR(reg) 0 // Only used by inline assembly
+
+//--- Memory sizes
+#define RAMSTART 0x60
+#define RAMEND   0x25F
+#define E2END    0x1FF
+#define FLASHEND 0x1FFF
+
+//--- Registers
+#define PINB   MOCK_REG(MOCK_PINB)
+#define DDRB   MOCK_REG(MOCK_DDRB)
+#define PORTB  MOCK_REG(MOCK_PORTB)
+#define PCMSK  MOCK_REG(MOCK_PCMSK)
+#define GIMSK  MOCK_REG(MOCK_GIMSK)
+#define GIFR   MOCK_REG(MOCK_GIFR)
+#define MCUCR  MOCK_REG(MOCK_MCUCR)
+#define MCUSR  MOCK_REG(MOCK_MCUSR)
+#define ADCSRA MOCK_REG(MOCK_ADCSRA)
+#define ADCSRB MOCK_REG(MOCK_ADCSRB)
+#define ADMUX  MOCK_REG(MOCK_ADMUX)
+#define ADCL   MOCK_REG(MOCK_ADCL)
+#define ADCH   MOCK_REG(MOCK_ADCH)
+#define DIDR0  MOCK_REG(MOCK_DIDR0)
+#define TCCR0A MOCK_REG(MOCK_TCCR0A)
+#define TCCR0B MOCK_REG(MOCK_TCCR0B)
+#define TCNT0  MOCK_REG(MOCK_TCNT0)
+#define OCR0A  MOCK_REG(MOCK_OCR0A)
+#define OCR0B  MOCK_REG(MOCK_OCR0B)
+#define TCCR1  MOCK_REG(MOCK_TCCR1)
+#define TCNT1  MOCK_REG(MOCK_TCNT1)
+#define OCR1A  MOCK_REG(MOCK_OCR1A)
+#define OCR1B  MOCK_REG(MOCK_OCR1B)
+#define OCR1C  MOCK_REG(MOCK_OCR1C)
+#define GTCCR  MOCK_REG(MOCK_GTCCR)
+#define TIMSK  MOCK_REG(MOCK_TIMSK)
+#define TIFR   MOCK_REG(MOCK_TIFR)
+#define PLLCSR MOCK_REG(MOCK_PLLCSR)
+#define CLKPR  MOCK_REG(MOCK_CLKPR)
+#define USICR  MOCK_REG(MOCK_USICR)
+#define USISR  MOCK_REG(MOCK_USISR)
+#define USIDR  MOCK_REG(MOCK_USIDR)
+#define USIBR  MOCK_REG(MOCK_USIBR)
+#define EEARL  MOCK_REG(MOCK_EEARL)
+#define EEARH  MOCK_REG(MOCK_EEARH)
+#define EEDR   MOCK_REG(MOCK_EEDR)
+#define EECR   MOCK_REG(MOCK_EECR)
+#define WDTCR  MOCK_REG(MOCK_WDTCR)
+#define OSCCAL MOCK_REG(MOCK_OSCCAL)
+#define SREG   MOCK_REG(MOCK_SREG)
+#define SPL    MOCK_REG(MOCK_SPL)
+#define SPH    MOCK_REG(MOCK_SPH)
+#define PRR    MOCK_REG(MOCK_PRR)
+
+//--- Port B
+#define PINB5  5
+#define PINB4  4
+#define PINB3  3
+#define PINB2  2
+#define PINB1  1
+#define PINB0  0
+#define DDB5   5
+#define DDB4   4
+#define DDB3   3
+#define DDB2   2
+#define DDB1   1
+#define DDB0   0
+#define PORTB5 5
+#define PORTB4 4
+#define PORTB3 3
+#define PORTB2 2
+#define PORTB1 1
+#define PORTB0 0
+#define PB5    5
+#define PB4    4
+#define PB3    3
+#define PB2    2
+#define PB1    1
+#define PB0    0
+
+//--- Pin change mask
+#define PCINT5 5
+#define PCINT4 4
+#define PCINT3 3
+#define PCINT2 2
+#define PCINT1 1
+#define PCINT0 0
+
+//--- Interrupt control
+#define INT0   6
+#define PCIE   5
+#define INTF0  6
+#define PCIF   5
+
+//--- MCU control and status
+#define BODS   7
+#define PUD    6
+#define SE     5
+#define SM1    4
+#define SM0    3
+#define BODSE  2
+#define ISC01  1
+#define ISC00  0
+#define WDRF   3
+#define BORF   2
+#define EXTRF  1
+#define PORF   0
+
+//--- ADC
+#define REFS1  7
+#define REFS0  6
+#define ADLAR  5
+#define REFS2  4
+#define MUX3   3
+#define MUX2   2
+#define MUX1   1
+#define MUX0   0
+#define ADEN   7
+#define ADSC   6
+#define ADATE  5
+#define ADIF   4
+#define ADIE   3
+#define ADPS2  2
+#define ADPS1  1
+#define ADPS0  0
+#define BIN    7
+#define ACME   6
+#define IPR    5
+#define ADTS2  2
+#define ADTS1  1
+#define ADTS0  0
+#define ADC0D  5
+#define ADC2D  4
+#define ADC3D  3
+#define ADC1D  2
+#define AIN1D  1
+#define AIN0D  0
+
+//--- Timer 0
+#define COM0A1 7
+#define COM0A0 6
+#define COM0B1 5
+#define COM0B0 4
+#define WGM01  1
+#define WGM00  0
+#define FOC0A  7
+#define FOC0B  6
+#define WGM02  3
+#define CS02   2
+#define CS01   1
+#define CS00   0
+
+//--- Timer 1
+#define CTC1   7
+#define PWM1A  6
+#define COM1A1 5
+#define COM1A0 4
+#define CS13   3
+#define CS12   2
+#define CS11   1
+#define CS10   0
+#define TSM    7
+#define PWM1B  6
+#define COM1B1 5
+#define COM1B0 4
+#define FOC1B  3
+#define FOC1A  2
+#define PSR1   1
+#define PSR0   0
+
+//--- Timer interrupts
+#define OCIE1A 6
+#define OCIE1B 5
+#define OCIE0A 4
+#define OCIE0B 3
+#define TOIE1  2
+#define TOIE0  1
+#define OCF1A  6
+#define OCF1B  5
+#define OCF0A  4
+#define OCF0B  3
+#define TOV1   2
+#define TOV0   1
+
+//--- Clock and PLL
+#define LSM    7
+#define PCKE   2
+#define PLLE   1
+#define PLOCK  0
+#define CLKPCE 7
+#define CLKPS3 3
+#define CLKPS2 2
+#define CLKPS1 1
+#define CLKPS0 0
+
+//--- USI
+#define USISIE 7
+#define USIOIE 6
+#define USIWM1 5
+#define USIWM0 4
+#define USICS1 3
+#define USICS0 2
+#define USICLK 1
+#define USITC  0
+#define USISIF 7
+#define USIOIF 6
+#define USIPF  5
+#define USIDC  4
+#define USICNT3 3
+#define USICNT2 2
+#define USICNT1 1
+#define USICNT0 0
+
+//--- EEPROM
+#define EEPM1  5
+#define EEPM0  4
+#define EERIE  3
+#define EEMPE  2
+#define EEPE   1
+#define EERE   0
+
+//--- Watchdog
+#define WDIF   7
+#define WDIE   6
+#define WDP3   5
+#define WDCE   4
+#define WDE    3
+#define WDP2   2
+#define WDP1   1
+#define WDP0   0
+
+//--- Power reduction
+#define PRTIM1 3
+#define PRTIM0 2
+#define PRUSI  1
+#define PRADC  0
+
+//--- Status register
+#define SREG_I 7
+#define SREG_T 6
+#define SREG_H 5
+#define SREG_S 4
+#define SREG_V 3
+#define SREG_N 2
+#define SREG_Z 1
+#define SREG_C 0
+
+#endif /* __MOCK_AVR_IO_H */
@@ -0,0 +1,22 @@
+/*--------------------------------------------------------------------------*
+* Program memory access for host builds
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Replaces <avr/pgmspace.h> when building on the host. There is only one
+* address space so PROGMEM data is read directly.
+*--------------------------------------------------------------------------*/
+#ifndef __MOCK_AVR_PGMSPACE_H
+#define __MOCK_AVR_PGMSPACE_H
+
+#include <stdint.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+
+#define pgm_read_byte_near(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word_near(addr) (*(const uint16_t *)(addr))
+#define pgm_read_byte(addr)      pgm_read_byte_near(addr)
+#define pgm_read_word(addr)      pgm_read_word_near(addr)
+
+#endif /* __MOCK_AVR_PGMSPACE_H */
@@ -0,0 +1,26 @@
+/*--------------------------------------------------------------------------*
+* Sleep mode support for host builds
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Replaces <avr/sleep.h> when building on the host. Sleeping advances the
+* emulation until the next interrupt.
+*--------------------------------------------------------------------------*/
+#ifndef __MOCK_AVR_SLEEP_H
+#define __MOCK_AVR_SLEEP_H
+
+#include <avr/io.h>
+
+#define SLEEP_MODE_IDLE     0
+#define SLEEP_MODE_ADC      (1 << SM0)
+#define SLEEP_MODE_PWR_DOWN (1 << SM1)
+
+#define set_sleep_mode(mode) \
+  MCUCR = (MCUCR & ~((1 << SM1) | (1 << SM0))) | (mode)
+
+#define sleep_enable()  MCUCR |= (1 << SE)
+#define sleep_disable() MCUCR &= ~(1 << SE)
+#define sleep_cpu()     mockSleep()
+#define sleep_mode()    mockSleep()
+
+#endif /* __MOCK_AVR_SLEEP_H */
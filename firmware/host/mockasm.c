@@ -0,0 +1,139 @@
+/*--------------------------------------------------------------------------*
+* Replacements for assembly language modules in host builds
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* The WS2812 driver (ws2812.c) and stack painting (stackcheck.c) are written
+* in inline assembly so they can't be compiled for the host. The LED driver
+* is replaced by a version that records the bytes that would be sent and
+* advances the emulation by the time it takes to send them. Stack painting
+* has no meaning on the host so the measurement functions return 0.
+*--------------------------------------------------------------------------*/
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "../hardware.h"
+#include "utility.h"
+#include "ws2812.h"
+
+// Size of the LED output buffer
+#define MOCK_LED_BUFFER 1024
+
+// Cycles per byte (8 bits at 800KHz)
+#define MOCK_LED_CYCLES ((8UL * F_CPU) / 800000UL)
+
+//! LED output buffer
+static uint8_t g_ledOutput[MOCK_LED_BUFFER];
+static uint16_t g_ledLength;
+
+/** Get the data sent to the WS2812 LED strip
+ *
+ * @param length receives the number of bytes available.
+ *
+ * @return a pointer to the data (after brightness scaling) sent since the
+ *         last reset or clear.
+ */
+const uint8_t *mockLedOutput(uint16_t *length) {
+  *length = g_ledLength;
+  return g_ledOutput;
+  }
+
+/** Discard any data sent to the LED strip */
+void mockLedClear() {
+  g_ledLength = 0;
+  }
+
+#ifdef WS2812_ENABLED
+
+/** Scale a single byte
+ *
+ * The same steps as the device code so the results match.
+ *
+ * @param value the value to scale.
+ * @param brightness the scale to apply.
+ *
+ * @return the scaled value.
+ */
+static uint8_t ws2812Scale(uint8_t value, uint8_t brightness) {
+  uint8_t result = 0;
+  value >>= 1;
+  for(uint8_t bit=0; bit<8; bit++) {
+    if(bit)
+      result >>= 1;
+    if(brightness & (1 << bit))
+      result += value;
+    }
+  return result;
+  }
+
+/** Record colour data from RAM or PROGMEM
+ *
+ * @param pData pointer to the GRB data.
+ * @param length the number of bytes to send.
+ * @param brightness scale applied to each byte (255 for full brightness).
+ * @param flash true if the data is in PROGMEM.
+ */
+static void ws2812Write(const uint8_t *pData, uint16_t length, uint8_t brightness, bool flash) {
+  for(; length>0; length--, pData++) {
+    uint8_t value = flash?pgm_read_byte(pData):*pData;
+    if(brightness!=255)
+      value = ws2812Scale(value, brightness);
+    if(g_ledLength<MOCK_LED_BUFFER)
+      g_ledOutput[g_ledLength++] = value;
+    mockAdvance(MOCK_LED_CYCLES);
+    }
+  }
+
+/** Initialise the LED strip pin
+ *
+ * Sets the data pin as an output and drives it low.
+ */
+void ws2812Init() {
+  PORTB &= ~(1 << WS2812_PIN);
+  DDRB |= (1 << WS2812_PIN);
+  }
+
+/** Send colour data from RAM
+ *
+ * @param pData pointer to the GRB data (3 bytes per LED).
+ * @param length the number of bytes to send.
+ * @param brightness scale applied to each byte (255 for full brightness).
+ */
+void ws2812Send(const uint8_t *pData, uint16_t length, uint8_t brightness) {
+  ws2812Write(pData, length, brightness, false);
+  }
+
+/** Send colour data from PROGMEM
+ *
+ * @param pData pointer to the GRB data (3 bytes per LED) in PROGMEM.
+ * @param length the number of bytes to send.
+ * @param brightness scale applied to each byte (255 for full brightness).
+ */
+void ws2812SendP(const uint8_t *pData, uint16_t length, uint8_t brightness) {
+  ws2812Write(pData, length, brightness, true);
+  }
+
+#endif /* WS2812_ENABLED */
+
+#ifdef STACK_CHECK_ENABLED
+
+/** Get the maximum stack depth reached so far
+ *
+ * Not available on the host.
+ *
+ * @return always 0.
+ */
+uint16_t ramHighWater() {
+  return 0;
+  }
+
+/** Get the smallest amount of free RAM seen so far
+ *
+ * Not available on the host.
+ *
+ * @return always 0.
+ */
+uint16_t ramUnused() {
+  return 0;
+  }
+
+#endif /* STACK_CHECK_ENABLED */
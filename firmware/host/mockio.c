@@ -0,0 +1,446 @@
+/*--------------------------------------------------------------------------*
+* Register level mock of the ATtiny85 for host builds
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Emulation of the IO registers and peripherals used by the shared library.
+* See mockio.h for details of what is (and isn't) emulated.
+*--------------------------------------------------------------------------*/
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <avr/io.h>
+
+// Size of the transition log
+#define MOCK_LOG_SIZE 4096
+
+// Size of the EEPROM
+#define MOCK_EEPROM_SIZE (E2END + 1)
+
+// EEPROM write time (3.4ms)
+#define MOCK_EEPROM_CYCLES ((F_CPU / 10000UL) * 34UL)
+
+//--- Interrupt vectors (only called if the program provides them)
+void PCINT0_vect(void) __attribute__((weak));
+void TIMER1_COMPA_vect(void) __attribute__((weak));
+void TIMER1_OVF_vect(void) __attribute__((weak));
+void TIMER0_OVF_vect(void) __attribute__((weak));
+void EE_RDY_vect(void) __attribute__((weak));
+void ADC_vect(void) __attribute__((weak));
+void TIMER0_COMPA_vect(void) __attribute__((weak));
+
+//! Register storage
+static volatile uint8_t g_registers[MOCK_REGISTERS];
+
+//! Cycle counter
+static uint64_t g_cycles;
+
+//! Externally driven input levels and the pins that are being driven
+static uint8_t g_inputs, g_driven;
+
+//! Last seen output state
+static uint8_t g_output;
+
+//! Transition log
+static MOCK_TRANSITION g_log[MOCK_LOG_SIZE];
+static uint16_t g_logStart, g_logCount;
+
+//! Timer prescaler counts
+static uint16_t g_prescale0, g_prescale1;
+
+//! Analog values
+static uint16_t g_analog[16];
+
+//! Cycles left for the current ADC conversion
+static uint16_t g_adcBusy;
+
+//! EEPROM contents
+static uint8_t g_eeprom[MOCK_EEPROM_SIZE];
+
+//! Cycles left for the current EEPROM write and the pending data
+static uint32_t g_eeBusy;
+static uint16_t g_eeAddress;
+static uint8_t g_eeData;
+
+//! Set while an interrupt handler is running
+static bool g_inIsr;
+
+//! Set when an interrupt handler has been called (wakes from sleep)
+static bool g_woken;
+
+//--- Write one to clear flag registers
+//
+// The interrupt flag registers (TIFR and GIFR) clear a flag when a one is
+// written to it. A register access only hands out a pointer so a read can't
+// be told apart from writing back the same value. Instead these registers
+// are accessed through a latch on a read only page - the first write to it
+// faults, the handler makes the page writable and notes the write and the
+// written value is applied to the flags before the emulation continues.
+
+// Number of flag registers
+#define MOCK_FLAGS 2
+
+//! The flag registers
+static const MOCK_REGISTER FLAG_REGISTERS[MOCK_FLAGS] = { MOCK_TIFR, MOCK_GIFR };
+
+//! Latch for each flag register (each on its own page)
+static volatile uint8_t *g_flagLatch[MOCK_FLAGS];
+
+//! Set when the latch has been written
+static volatile bool g_flagWritten[MOCK_FLAGS];
+
+//! Page size
+static size_t g_pageSize;
+
+// Direct access to register storage
+#define REG(name) g_registers[MOCK_##name]
+
+/** Handle a write to a flag latch
+ *
+ * Makes the page writable so the write can complete when the handler
+ * returns. Faults anywhere else get the default handling.
+ */
+static void mockFlagFault(int sig, siginfo_t *info, void *context) {
+  for(uint8_t index=0; index<MOCK_FLAGS; index++) {
+    if((uint8_t *)info->si_addr==g_flagLatch[index]) {
+      mprotect((void *)g_flagLatch[index], g_pageSize, PROT_READ | PROT_WRITE);
+      g_flagWritten[index] = true;
+      return;
+      }
+    }
+  signal(SIGSEGV, SIG_DFL);
+  }
+
+/** Apply any writes to the flag latches
+ *
+ * Every flag written as one is cleared.
+ */
+static void mockFlagUpdate() {
+  for(uint8_t index=0; index<MOCK_FLAGS; index++) {
+    if(g_flagWritten[index]) {
+      g_registers[FLAG_REGISTERS[index]] &= ~*g_flagLatch[index];
+      g_flagWritten[index] = false;
+      mprotect((void *)g_flagLatch[index], g_pageSize, PROT_READ);
+      }
+    }
+  }
+
+/** Get the latch for a flag register
+ *
+ * The latch is loaded with the current flags and left read only. The
+ * first call installs the SIGSEGV handler, the program is aborted if the
+ * latch page can't be allocated.
+ *
+ * @param index the index of the flag register.
+ *
+ * @return a pointer to the latch.
+ */
+static volatile uint8_t *mockFlagLatch(uint8_t index) {
+  if(g_flagLatch[index]==NULL) {
+    if(g_pageSize==0) {
+      g_pageSize = sysconf(_SC_PAGESIZE);
+      struct sigaction action;
+      memset(&action, 0, sizeof(action));
+      action.sa_sigaction = mockFlagFault;
+      action.sa_flags = SA_SIGINFO | SA_NODEFER;
+      sigaction(SIGSEGV, &action, NULL);
+      }
+    void *page = mmap(NULL, g_pageSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(page==MAP_FAILED) {
+      perror("mockio: unable to map a flag register latch");
+      abort();
+      }
+    g_flagLatch[index] = page;
+    }
+  mprotect((void *)g_flagLatch[index], g_pageSize, PROT_READ | PROT_WRITE);
+  *g_flagLatch[index] = g_registers[FLAG_REGISTERS[index]];
+  mprotect((void *)g_flagLatch[index], g_pageSize, PROT_READ);
+  return g_flagLatch[index];
+  }
+
+/** Call an interrupt handler
+ *
+ * Interrupts are disabled while the handler runs (as they would be on the
+ * chip) and enabled again afterwards.
+ *
+ * @param handler the handler to call (may be NULL).
+ */
+static void mockInterrupt(void (*handler)(void)) {
+  g_woken = true;
+  if(handler==NULL)
+    return;
+  g_inIsr = true;
+  REG(SREG) &= ~(1 << SREG_I);
+  handler();
+  REG(SREG) |= (1 << SREG_I);
+  g_inIsr = false;
+  }
+
+/** Bring the emulated state up to date
+ *
+ * Logs output changes, recalculates the input pins, starts ADC conversions
+ * and EEPROM operations and dispatches pending interrupts.
+ */
+static void mockUpdate() {
+  // Apply writes to the flag registers
+  mockFlagUpdate();
+  // Track the outputs
+  uint8_t output = REG(PORTB) & REG(DDRB);
+  if(output!=g_output) {
+    g_output = output;
+    uint16_t index = (g_logStart + g_logCount) % MOCK_LOG_SIZE;
+    g_log[index].cycle = g_cycles;
+    g_log[index].output = output;
+    if(g_logCount<MOCK_LOG_SIZE)
+      g_logCount++;
+    else
+      g_logStart = (g_logStart + 1) % MOCK_LOG_SIZE;
+    }
+  // Inputs read the driven level or the pull up state
+  uint8_t level = (g_inputs & g_driven) | (REG(PORTB) & ~g_driven);
+  uint8_t pins = (output | (level & ~REG(DDRB))) & 0x3F;
+  if((pins ^ REG(PINB)) & REG(PCMSK))
+    REG(GIFR) |= (1 << PCIF);
+  REG(PINB) = pins;
+  // Start an ADC conversion (13 ADC clocks, 25 for the first)
+  if((REG(ADCSRA) & (1 << ADEN))&&(REG(ADCSRA) & (1 << ADSC))&&(g_adcBusy==0)) {
+    uint8_t prescale = REG(ADCSRA) & 0x07;
+    g_adcBusy = 13 * (prescale?(1 << prescale):2);
+    }
+  // EEPROM access
+  if(REG(EECR) & (1 << EERE)) {
+    REG(EEDR) = g_eeprom[((REG(EEARH) << 8) | REG(EEARL)) % MOCK_EEPROM_SIZE];
+    REG(EECR) &= ~(1 << EERE);
+    }
+  if((REG(EECR) & (1 << EEPE))&&(g_eeBusy==0)) {
+    g_eeAddress = ((REG(EEARH) << 8) | REG(EEARL)) % MOCK_EEPROM_SIZE;
+    g_eeData = REG(EEDR);
+    g_eeBusy = MOCK_EEPROM_CYCLES;
+    REG(EECR) &= ~(1 << EEMPE);
+    }
+  // Dispatch interrupts in vector order
+  if(g_inIsr||!(REG(SREG) & (1 << SREG_I)))
+    return;
+  if((REG(GIFR) & (1 << PCIF))&&(REG(GIMSK) & (1 << PCIE))) {
+    REG(GIFR) &= ~(1 << PCIF);
+    mockInterrupt(PCINT0_vect);
+    }
+  else if((REG(TIFR) & (1 << OCF1A))&&(REG(TIMSK) & (1 << OCIE1A))) {
+    REG(TIFR) &= ~(1 << OCF1A);
+    mockInterrupt(TIMER1_COMPA_vect);
+    }
+  else if((REG(TIFR) & (1 << TOV1))&&(REG(TIMSK) & (1 << TOIE1))) {
+    REG(TIFR) &= ~(1 << TOV1);
+    mockInterrupt(TIMER1_OVF_vect);
+    }
+  else if((REG(TIFR) & (1 << TOV0))&&(REG(TIMSK) & (1 << TOIE0))) {
+    REG(TIFR) &= ~(1 << TOV0);
+    mockInterrupt(TIMER0_OVF_vect);
+    }
+  else if((REG(EECR) & (1 << EERIE))&&!(REG(EECR) & (1 << EEPE)))
+    mockInterrupt(EE_RDY_vect);
+  else if((REG(ADCSRA) & (1 << ADIF))&&(REG(ADCSRA) & (1 << ADIE))) {
+    REG(ADCSRA) &= ~(1 << ADIF);
+    mockInterrupt(ADC_vect);
+    }
+  else if((REG(TIFR) & (1 << OCF0A))&&(REG(TIMSK) & (1 << OCIE0A))) {
+    REG(TIFR) &= ~(1 << OCF0A);
+    mockInterrupt(TIMER0_COMPA_vect);
+    }
+  }
+
+/** Advance the peripherals by a single cycle
+ */
+static void mockStep() {
+  // Writes to the flag registers happen before the next cycle
+  mockFlagUpdate();
+  g_cycles++;
+  // Timer 0
+  static const uint16_t PRESCALE0[] = { 0, 1, 8, 64, 256, 1024, 0, 0 };
+  uint16_t divide = PRESCALE0[REG(TCCR0B) & 0x07];
+  if((divide>0)&&(++g_prescale0>=divide)) {
+    g_prescale0 = 0;
+    bool ctc = (REG(TCCR0A) & ((1 << WGM01) | (1 << WGM00)))==(1 << WGM01);
+    if(ctc&&(REG(TCNT0)==REG(OCR0A)))
+      REG(TCNT0) = 0;
+    else if(++REG(TCNT0)==0)
+      REG(TIFR) |= (1 << TOV0);
+    if(REG(TCNT0)==REG(OCR0A))
+      REG(TIFR) |= (1 << OCF0A);
+    }
+  // Timer 1
+  if(REG(GTCCR) & (1 << PSR1)) {
+    g_prescale1 = 0;
+    REG(GTCCR) &= ~(1 << PSR1);
+    }
+  uint8_t select = REG(TCCR1) & 0x0F;
+  if((select>0)&&(++g_prescale1>=(1 << (select - 1)))) {
+    g_prescale1 = 0;
+    if((REG(TCCR1) & (1 << CTC1))&&(REG(TCNT1)==REG(OCR1C))) {
+      REG(TCNT1) = 0;
+      REG(TIFR) |= (1 << TOV1);
+      }
+    else if(++REG(TCNT1)==0)
+      REG(TIFR) |= (1 << TOV1);
+    if(REG(TCNT1)==REG(OCR1A))
+      REG(TIFR) |= (1 << OCF1A);
+    }
+  // ADC conversion
+  if((g_adcBusy>0)&&(--g_adcBusy==0)) {
+    uint16_t value = g_analog[REG(ADMUX) & 0x0F] & 0x3FF;
+    if(REG(ADMUX) & (1 << ADLAR))
+      value = value << 6;
+    REG(ADCL) = value & 0xFF;
+    REG(ADCH) = value >> 8;
+    REG(ADCSRA) = (REG(ADCSRA) & ~(1 << ADSC)) | (1 << ADIF);
+    }
+  // EEPROM write
+  if((g_eeBusy>0)&&(--g_eeBusy==0)) {
+    g_eeprom[g_eeAddress] = g_eeData;
+    REG(EECR) &= ~(1 << EEPE);
+    }
+  mockUpdate();
+  }
+
+/** Access a register
+ *
+ * Brings the emulation up to date and returns a pointer to the storage for
+ * the register. Used by the register definitions in avr/io.h. The flag
+ * registers (TIFR and GIFR) are write one to clear.
+ *
+ * @param reg the register to access.
+ *
+ * @return a pointer to the register value.
+ */
+volatile uint8_t *mockRegister(MOCK_REGISTER reg) {
+  mockStep();
+  for(uint8_t index=0; index<MOCK_FLAGS; index++) {
+    if(reg==FLAG_REGISTERS[index])
+      return mockFlagLatch(index);
+    }
+  return &g_registers[reg];
+  }
+
+/** Reset the emulated chip
+ *
+ * Clears all registers, the cycle counter, the transition log, the UART
+ * and LED strip buffers and the EEPROM (to 0xFF).
+ */
+void mockReset() {
+  mockFlagUpdate();
+  memset((void *)g_registers, 0, sizeof(g_registers));
+  REG(SPL) = RAMEND & 0xFF;
+  REG(SPH) = RAMEND >> 8;
+  g_cycles = 0;
+  g_inputs = 0;
+  g_driven = 0;
+  g_output = 0;
+  g_logStart = 0;
+  g_logCount = 0;
+  g_prescale0 = 0;
+  g_prescale1 = 0;
+  memset(g_analog, 0, sizeof(g_analog));
+  g_adcBusy = 0;
+  memset(g_eeprom, 0xFF, sizeof(g_eeprom));
+  g_eeBusy = 0;
+  g_inIsr = false;
+  mockUartClear();
+  mockLedClear();
+  }
+
+/** Advance the emulation by a number of cycles
+ *
+ * Timers are updated and any interrupts that become due are called.
+ *
+ * @param cycles the number of CPU cycles to advance.
+ */
+void mockAdvance(uint32_t cycles) {
+  for(; cycles>0; cycles--)
+    mockStep();
+  }
+
+/** Get the number of cycles executed since the last reset
+ */
+uint64_t mockCycles() {
+  return g_cycles;
+  }
+
+/** Sleep until an interrupt occurs
+ *
+ * Advances the emulation until an interrupt handler is called or about one
+ * second has passed.
+ */
+void mockSleep() {
+  g_woken = false;
+  for(uint32_t limit=F_CPU; (limit>0)&&!g_woken; limit--)
+    mockStep();
+  }
+
+/** Enable interrupts */
+void mockSei() {
+  REG(SREG) |= (1 << SREG_I);
+  }
+
+/** Disable interrupts */
+void mockCli() {
+  REG(SREG) &= ~(1 << SREG_I);
+  }
+
+/** Drive an input pin
+ *
+ * Sets the external level on a port B pin. If the pin is an input and pin
+ * change interrupts are enabled for it the interrupt will be triggered.
+ *
+ * @param pin the pin number (0 to 5).
+ * @param level the new level.
+ */
+void mockPinInput(uint8_t pin, bool level) {
+  g_driven |= (1 << pin);
+  if(level)
+    g_inputs |= (1 << pin);
+  else
+    g_inputs &= ~(1 << pin);
+  mockUpdate();
+  }
+
+/** Set the value returned for an ADC channel
+ *
+ * @param channel the channel number (the MUX bits of ADMUX).
+ * @param value the 10 bit value to return.
+ */
+void mockAnalog(uint8_t channel, uint16_t value) {
+  g_analog[channel & 0x0F] = value;
+  }
+
+/** Get the number of output transitions recorded
+ */
+uint16_t mockTransitions() {
+  return g_logCount;
+  }
+
+/** Get a recorded output transition
+ *
+ * @param index the index of the transition (0 is the oldest).
+ *
+ * @return a pointer to the transition or NULL if the index is invalid.
+ */
+const MOCK_TRANSITION *mockTransition(uint16_t index) {
+  if(index>=g_logCount)
+    return NULL;
+  return &g_log[(g_logStart + index) % MOCK_LOG_SIZE];
+  }
+
+/** Discard all recorded transitions */
+void mockClearTransitions() {
+  g_logStart = 0;
+  g_logCount = 0;
+  }
+
+/** Access the emulated EEPROM (512 bytes) */
+uint8_t *mockEeprom() {
+  return g_eeprom;
+  }
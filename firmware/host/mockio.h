@@ -0,0 +1,189 @@
+/*--------------------------------------------------------------------------*
+* Register level mock of the ATtiny85 for host builds
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Provides storage for the IO registers and a simple emulation of the parts
+* of the chip used by the shared library so that code can be compiled and
+* exercised on the host. Every register access goes through mockRegister()
+* which keeps the emulated peripherals up to date and advances the cycle
+* counter by one.
+*
+* Emulated:
+*   - Port B with a log of output transitions (stamped with the cycle count)
+*   - TIMER0 and TIMER1 counters, prescalers and overflow interrupts
+*   - Write one to clear interrupt flags (TIFR and GIFR)
+*   - The ADC (conversions complete on the next access to ADCSRA)
+*   - Pin change interrupts on port B
+*   - The EEPROM (reads are immediate, writes take 3.4ms)
+*
+* The USI is not emulated and inline assembly is not available so the soft
+* UART is replaced by a buffered version that records the output and takes
+* input from a buffer. The WS2812 driver records the bytes sent instead and
+* the stack painting functions (ramHighWater() and ramUnused()) return 0.
+*
+* NOTE: The interrupt flag registers (TIFR and GIFR) are emulated with a
+* read only page and a process wide SIGSEGV handler, installed on the first
+* access to either of them. Faults anywhere else restore the default action
+* and crash as usual. A test that installs its own SIGSEGV handler must
+* pass faults it does not handle on to the previous one (from sigaction())
+* or flag register writes will stop working.
+*--------------------------------------------------------------------------*/
+#ifndef __MOCKIO_H
+#define __MOCKIO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Registers provided by the mock
+ */
+typedef enum _MOCK_REGISTER {
+  MOCK_PINB, MOCK_DDRB, MOCK_PORTB, MOCK_PCMSK, MOCK_GIMSK, MOCK_GIFR,
+  MOCK_MCUCR, MOCK_MCUSR, MOCK_ADCSRA, MOCK_ADCSRB, MOCK_ADMUX, MOCK_ADCL,
+  MOCK_ADCH, MOCK_DIDR0, MOCK_TCCR0A, MOCK_TCCR0B, MOCK_TCNT0, MOCK_OCR0A,
+  MOCK_OCR0B, MOCK_TCCR1, MOCK_TCNT1, MOCK_OCR1A, MOCK_OCR1B, MOCK_OCR1C,
+  MOCK_GTCCR, MOCK_TIMSK, MOCK_TIFR, MOCK_PLLCSR, MOCK_CLKPR, MOCK_USICR,
+  MOCK_USISR, MOCK_USIDR, MOCK_USIBR, MOCK_EEARL, MOCK_EEARH, MOCK_EEDR,
+  MOCK_EECR, MOCK_WDTCR, MOCK_OSCCAL, MOCK_SREG, MOCK_SPL, MOCK_SPH,
+  MOCK_PRR,
+  MOCK_REGISTERS //!< Number of registers
+  } MOCK_REGISTER;
+
+/** Access a register
+ *
+ * Brings the emulation up to date and returns a pointer to the storage for
+ * the register. Used by the register definitions in avr/io.h. The flag
+ * registers (TIFR and GIFR) are write one to clear.
+ *
+ * @param reg the register to access.
+ *
+ * @return a pointer to the register value.
+ */
+volatile uint8_t *mockRegister(MOCK_REGISTER reg);
+
+/** Reset the emulated chip
+ *
+ * Clears all registers, the cycle counter, the transition log, the UART
+ * and LED strip buffers and the EEPROM (to 0xFF).
+ */
+void mockReset();
+
+/** Advance the emulation by a number of cycles
+ *
+ * Timers are updated and any interrupts that become due are called.
+ *
+ * @param cycles the number of CPU cycles to advance.
+ */
+void mockAdvance(uint32_t cycles);
+
+/** Get the number of cycles executed since the last reset
+ */
+uint64_t mockCycles();
+
+/** Sleep until an interrupt occurs
+ *
+ * Advances the emulation until an interrupt handler is called or about one
+ * second has passed.
+ */
+void mockSleep();
+
+/** Enable interrupts */
+void mockSei();
+
+/** Disable interrupts */
+void mockCli();
+
+/** Drive an input pin
+ *
+ * Sets the external level on a port B pin. If the pin is an input and pin
+ * change interrupts are enabled for it the interrupt will be triggered.
+ *
+ * @param pin the pin number (0 to 5).
+ * @param level the new level.
+ */
+void mockPinInput(uint8_t pin, bool level);
+
+/** Set the value returned for an ADC channel
+ *
+ * @param channel the channel number (the MUX bits of ADMUX).
+ * @param value the 10 bit value to return.
+ */
+void mockAnalog(uint8_t channel, uint16_t value);
+
+/** A single change to the port B outputs
+ */
+typedef struct _MOCK_TRANSITION {
+  uint64_t cycle;  //!< Cycle count when the change was seen
+  uint8_t  output; //!< New output state (PORTB & DDRB)
+  } MOCK_TRANSITION;
+
+/** Get the number of output transitions recorded
+ */
+uint16_t mockTransitions();
+
+/** Get a recorded output transition
+ *
+ * @param index the index of the transition (0 is the oldest).
+ *
+ * @return a pointer to the transition or NULL if the index is invalid.
+ */
+const MOCK_TRANSITION *mockTransition(uint16_t index);
+
+/** Discard all recorded transitions */
+void mockClearTransitions();
+
+/** Access the emulated EEPROM (512 bytes) */
+uint8_t *mockEeprom();
+
+/** Add data to the UART input buffer
+ *
+ * @param data pointer to the data to add.
+ * @param length the number of bytes to add.
+ */
+void mockUartInput(const uint8_t *data, uint16_t length);
+
+/** Get the data sent on the UART
+ *
+ * @param length receives the number of bytes available.
+ *
+ * @return a pointer to the data sent since the last reset or clear.
+ */
+const uint8_t *mockUartOutput(uint16_t *length);
+
+/** Discard all pending UART input and any data sent on the UART */
+void mockUartClear();
+
+/** Simulate another node holding the bus
+ *
+ * The next characters sent on the multi-drop bus (BUS_ENABLED) lose to
+ * another node and are not recorded. Characters skipped because a
+ * collision has already been seen do not count.
+ *
+ * @param count the number of characters that collide.
+ */
+void mockUartCollide(uint16_t count);
+
+/** Get the data sent to the WS2812 LED strip
+ *
+ * @param length receives the number of bytes available.
+ *
+ * @return a pointer to the data (after brightness scaling) sent since the
+ *         last reset or clear.
+ */
+const uint8_t *mockLedOutput(uint16_t *length);
+
+/** Discard any data sent to the LED strip */
+void mockLedClear();
+
+// Cycle exact delays just advance the emulation
+#define __builtin_avr_delay_cycles(cycles) mockAdvance(cycles)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOCKIO_H */
@@ -0,0 +1,154 @@
+/*--------------------------------------------------------------------------*
+* Buffered UART for host builds
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Replaces the assembly language soft UART (uart_send.c and uart_recv.c)
+* when building on the host. Output is recorded and input is taken from a
+* buffer filled by the test code. Each character advances the emulation by
+* the time it would take to send at BAUD_RATE.
+*--------------------------------------------------------------------------*/
+#include <string.h>
+#include "../hardware.h"
+#include "softuart.h"
+#ifdef BUS_ENABLED
+#  include "../shared/uart_defs.h"
+#endif
+
+// Size of the input and output buffers
+#define MOCK_UART_BUFFER 4096
+
+// Cycles per character (8N1 framing)
+#define MOCK_UART_CYCLES ((10UL * F_CPU) / BAUD_RATE)
+
+//! Output buffer
+static uint8_t g_output[MOCK_UART_BUFFER];
+static uint16_t g_outputLength;
+
+//! Input buffer
+static uint8_t g_input[MOCK_UART_BUFFER];
+static uint16_t g_inputHead, g_inputLength;
+
+//! Number of characters still to collide with another node
+static uint16_t g_collisions;
+
+/** Add data to the UART input buffer
+ *
+ * @param data pointer to the data to add.
+ * @param length the number of bytes to add.
+ */
+void mockUartInput(const uint8_t *data, uint16_t length) {
+  // Move pending data to the start of the buffer
+  memmove(g_input, g_input + g_inputHead, g_inputLength);
+  g_inputHead = 0;
+  if(length>(MOCK_UART_BUFFER - g_inputLength))
+    length = MOCK_UART_BUFFER - g_inputLength;
+  memcpy(g_input + g_inputLength, data, length);
+  g_inputLength += length;
+  }
+
+/** Get the data sent on the UART
+ *
+ * @param length receives the number of bytes available.
+ *
+ * @return a pointer to the data sent since the last reset or clear.
+ */
+const uint8_t *mockUartOutput(uint16_t *length) {
+  *length = g_outputLength;
+  return g_output;
+  }
+
+/** Discard all pending UART input and any data sent on the UART */
+void mockUartClear() {
+  g_outputLength = 0;
+  g_inputHead = 0;
+  g_inputLength = 0;
+  g_collisions = 0;
+  }
+
+/** Simulate another node holding the bus
+ *
+ * The next characters sent on the multi-drop bus lose to another node (as
+ * the real transmit loop does when it sees the line low) and are not
+ * recorded. Characters skipped because a collision has already been seen
+ * do not count.
+ *
+ * @param count the number of characters that collide.
+ */
+void mockUartCollide(uint16_t count) {
+  g_collisions = count;
+  }
+
+// Only if enabled
+#ifdef UART_ENABLED
+
+/** Initialise the UART
+ */
+void uartInit() {
+  // Nothing to do
+  }
+
+/** Write a single character
+ *
+ * Send a single character on the UART.
+ *
+ * @param ch the character to send.
+ */
+void uartSend(char ch) {
+#ifdef BUS_ENABLED
+  // Nothing more is sent once a collision has been seen
+  if(g_busCollision)
+    return;
+  if(g_collisions>0) {
+    g_collisions--;
+    g_busCollision = true;
+    g_busState = BUS_IGNORE;
+    mockAdvance(MOCK_UART_CYCLES);
+    return;
+    }
+#endif
+  if(g_outputLength<MOCK_UART_BUFFER)
+    g_output[g_outputLength++] = ch;
+  mockAdvance(MOCK_UART_CYCLES);
+  }
+
+/** Determine if characters are available
+ *
+ * @return the number of characters available in the input buffer.
+ */
+uint8_t uartAvail() {
+  return (g_inputLength>255)?255:g_inputLength;
+  }
+
+/** Receive a single character
+ *
+ * On the host this does not block, if no input is available it returns 0.
+ *
+ * @return the character received.
+ */
+char uartRecv() {
+  if(g_inputLength==0)
+    return 0;
+  mockAdvance(MOCK_UART_CYCLES);
+  g_inputLength--;
+  return g_input[g_inputHead++];
+  }
+
+#ifdef PCINT_ENABLED
+/** Pin change handler for the dispatcher
+ *
+ * Input is taken directly from the buffer so there is nothing to do here.
+ */
+void uartPinChange() {
+  }
+#endif
+
+#endif /* UART_ENABLED */
+
+/** Pin change handlers for the additional channels
+ *
+ * The additional channels are not emulated on the host (uart1.c is excluded
+ * from the host build), these keep the dispatcher linking.
+ */
+#define MOCK_CHANNEL(name, rx) void name##PinChange() { }
+UART_CHANNELS(MOCK_CHANNEL)
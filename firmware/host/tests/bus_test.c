@@ -0,0 +1,94 @@
+/*--------------------------------------------------------------------------*
+* Multi-drop bus tests
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Sends frames with another node holding the bus so every attempt collides
+* and busSend() has to go through all of its retries. Every node address
+* is used so the last retry sees every possible backoff value, including
+* the ones that push the idle wait past 255 bit times. A frame sent on a
+* quiet bus goes out once and unchanged.
+*--------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "../../hardware.h"
+#include "packet.h"
+#include "bus.h"
+#include "check.h"
+
+// CPU cycles per bit (see bus.c)
+#define BUS_BIT_CYCLES (F_CPU / BAUD_RATE)
+
+// Number of bit times the line must be idle (see bus.c)
+#define BUS_IDLE_BITS 11
+
+// Longest time busSend() can take when every attempt collides - the idle
+// wait with the largest backoff plus a character for each attempt (each
+// bit of the wait also reads PINB).
+#define BUS_MAX_CYCLES \
+  (BUS_RETRIES * ((BUS_IDLE_BITS + 255UL) * (BUS_BIT_CYCLES + 1) + (10UL * BUS_BIT_CYCLES)))
+
+/** Start a node with the line released
+ */
+static void startNode(uint8_t address) {
+  mockReset();
+  mockPinInput(UART_RX, true);
+  busInit(address);
+  sei();
+  }
+
+/** Every retry collides, from every point in the backoff sequence
+ */
+static void testRetries() {
+  const uint8_t payload[] = { 0x01, 0x00, 0x02 };
+  // The seed is the address, 255 completes the sequence
+  for(uint16_t address=1; address<=255; address++) {
+    startNode(address);
+    mockUartCollide(BUS_RETRIES);
+    uint64_t start = mockCycles();
+    CHECK(!busSend(2, payload, sizeof(payload)));
+    CHECK((mockCycles() - start)<=BUS_MAX_CYCLES);
+    uint16_t length;
+    mockUartOutput(&length);
+    CHECK(length==0);
+    // The bus is usable again afterwards
+    CHECK(busSend(2, payload, sizeof(payload)));
+    }
+  }
+
+/** A frame on a quiet bus is sent once
+ */
+static void testSend() {
+  const uint8_t payload[] = { 0x10, 0x00, 0x20, 0x30 };
+  uint8_t frame[16];
+  uint16_t length;
+  // The frame is the delimiter and address followed by the packet
+  mockReset();
+  packetSend(payload, sizeof(payload));
+  const uint8_t *output = mockUartOutput(&length);
+  frame[0] = PACKET_END;
+  frame[1] = 7;
+  memcpy(frame + 2, output, length);
+  uint16_t size = length + 2;
+  startNode(1);
+  CHECK(busSend(7, payload, sizeof(payload)));
+  output = mockUartOutput(&length);
+  CHECK((length==size)&&(memcmp(output, frame, size)==0));
+  // A single collision is retried
+  mockUartClear();
+  mockUartCollide(1);
+  CHECK(busSend(7, payload, sizeof(payload)));
+  output = mockUartOutput(&length);
+  CHECK((length==size)&&(memcmp(output, frame, size)==0));
+  }
+
+/** Program entry point
+ */
+int main() {
+  testSend();
+  testRetries();
+  return CHECK_RESULT("bus_test");
+  }
@@ -0,0 +1,121 @@
+#!/usr/bin/env python
+#----------------------------------------------------------------------------
+# 19-Oct-2026 ShaneG
+#
+# Runs the bus polling daemon (tools/busd.py) against simulated nodes on a
+# pty - every node is polled and answers, lost requests time out and the
+# simulator stops cleanly when the host side closes, even part way through
+# sending a response.
+#----------------------------------------------------------------------------
+from os import path
+from sys import path as modules, exit
+from time import time, sleep
+import random
+import select
+
+BASE_DIR = path.dirname(path.abspath(__file__))
+modules.insert(0, path.join(BASE_DIR, "..", "..", "tools"))
+from busd import BusPoller, BusSimulator
+
+#--- Test settings
+HOST     = 0xFE
+NODES    = range(1, 9)
+INTERVAL = 0.1
+TIMEOUT  = 0.1
+WINDOW   = 4
+
+g_failures = 0
+
+def check(cond, message):
+  """ Report a failed check
+  """
+  global g_failures
+  if not cond:
+    print "busd_test.py: check failed: %s" % message
+    g_failures = g_failures + 1
+
+class Simulator(BusSimulator):
+  """ Simulator that records an exception instead of printing it
+  """
+
+  def run(self):
+    self.failure = None
+    try:
+      BusSimulator.run(self)
+    except Exception, ex:
+      self.failure = ex
+
+def poll(loss, duration):
+  """ Poll simulated nodes for a while
+
+    Returns the poller and the simulator (still running).
+  """
+  simulator = Simulator(NODES, loss, 0.01)
+  simulator.start()
+  poller = BusPoller(HOST, NODES, INTERVAL, TIMEOUT, WINDOW, "P")
+  poller.connectEx(simulator.stream())
+  finish = time() + duration
+  while time() < finish:
+    due = poller.service(time())
+    wait = max(0.0, min(due - time(), TIMEOUT / 4))
+    if len(select.select([ poller.stream ], [], [], wait)[0]) > 0:
+      poller.receive(time())
+  return poller, simulator
+
+def stop(poller, simulator):
+  """ Close the host side and check the simulator stops without an error
+  """
+  poller.disconnect()
+  simulator.join(2.0)
+  check(not simulator.isAlive(), "simulator still running after disconnect")
+  check(simulator.failure is None, "simulator failed with %r" % simulator.failure)
+
+def testPolling():
+  """ Every node is polled and every response is matched to its request
+  """
+  poller, simulator = poll(0.0, 1.0)
+  report = poller.report()
+  check(report["errors"] == 0, "%d invalid frames" % report["errors"])
+  for node in report["nodes"]:
+    name = "node %d" % node["address"]
+    check(node["sent"] >= 5, "%s only polled %d times" % (name, node["sent"]))
+    check(node["received"] + node["pending"] == node["sent"], "%s lost responses" % name)
+    check(node["timeouts"] == 0, "%s had %d timeouts" % (name, node["timeouts"]))
+    check(node["bytes"] == (node["received"] * 4), "%s received %d bytes" % (name, node["bytes"]))
+  data = poller.data()
+  check(sorted([ int(address) for address in data.keys() ]) == NODES, "no data from some nodes")
+  stop(poller, simulator)
+
+def testTimeouts():
+  """ Requests the nodes ignore are counted as timeouts
+  """
+  poller, simulator = poll(0.5, 1.0)
+  sent = received = timeouts = pending = 0
+  for node in poller.report()["nodes"]:
+    sent = sent + node["sent"]
+    received = received + node["received"]
+    timeouts = timeouts + node["timeouts"]
+    pending = pending + node["pending"]
+  check((received > 0) and (timeouts > 0), "%d received, %d timeouts" % (received, timeouts))
+  check(received + timeouts + pending == sent, "%d requests not accounted for" % (sent - received - timeouts - pending))
+  stop(poller, simulator)
+
+def testClose():
+  """ Closing the host while a response is being prepared stops the simulator
+  """
+  random.seed(1)
+  simulator = Simulator(NODES, 0.0, 0.5)
+  simulator.start()
+  poller = BusPoller(HOST, NODES[:1], INTERVAL, TIMEOUT, WINDOW, "P")
+  poller.connectEx(simulator.stream())
+  poller.service(time())
+  # The simulator is waiting before it responds
+  sleep(0.02)
+  stop(poller, simulator)
+
+if __name__ == "__main__":
+  testPolling()
+  testTimeouts()
+  testClose()
+  print "busd_test.py: %s" % ("FAILED" if g_failures else "passed")
+  exit(1 if g_failures else 0)
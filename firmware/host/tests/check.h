@@ -0,0 +1,32 @@
+/*--------------------------------------------------------------------------*
+* Minimal test helpers for host tests
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Each test is a program linked against the host build of the library that
+* reports failed checks and exits with a non zero status if any failed.
+*--------------------------------------------------------------------------*/
+#ifndef __CHECK_H
+#define __CHECK_H
+
+#include <stdio.h>
+
+//! Number of failed checks
+static int g_checkFailures = 0;
+
+/** Check a condition, reporting the location if it is false
+ */
+#define CHECK(cond) \
+  do { \
+    if(!(cond)) { \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      g_checkFailures++; \
+      } \
+    } while(0)
+
+/** Report the result and get the exit status for main()
+ */
+#define CHECK_RESULT(name) \
+  (printf("%s: %s\n", name, g_checkFailures?"FAILED":"passed"), (g_checkFailures?1:0))
+
+#endif /* __CHECK_H */
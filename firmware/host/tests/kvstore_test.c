@@ -0,0 +1,169 @@
+/*--------------------------------------------------------------------------*
+* EEPROM key/value store tests
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Cuts the power at random points while values are being written and
+* checks that every key still has either the last value that was flushed
+* or the newer one that was being written - never garbage and never
+* nothing. The byte being programmed when the power goes is corrupted.
+* The case where the slot about to be written holds the only copy of a key
+* that has just been changed is also tested at every stage of the write.
+*--------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "../../hardware.h"
+#include "kvstore.h"
+#include "check.h"
+
+// EEPROM write time in cycles (3.4ms)
+#define EEPROM_CYCLES ((F_CPU / 10000UL) * 34UL)
+
+// Number of record slots (see kvstore.c)
+#define KV_SLOTS (KV_EEPROM_SIZE / (KV_VALUE_SIZE + 4))
+
+// Number of power cycles to test
+#define POWER_CYCLES 400
+
+//! Last value known to be in EEPROM for each key
+static uint8_t g_stored[KV_KEYS][KV_VALUE_SIZE];
+static bool g_known[KV_KEYS];
+
+//! Value set since then (if any)
+static uint8_t g_pending[KV_KEYS][KV_VALUE_SIZE];
+static bool g_changed[KV_KEYS];
+
+/** Remove power and start again
+ *
+ * Keeps the EEPROM contents (corrupting the byte being written if there is
+ * one) and resets everything else.
+ */
+static void powerCycle() {
+  static uint8_t eeprom[512];
+  cli();
+  if(EECR & (1 << EEPE))
+    mockEeprom()[((EEARH << 8) | EEARL) % sizeof(eeprom)] = rand();
+  memcpy(eeprom, mockEeprom(), sizeof(eeprom));
+  mockReset();
+  memcpy(mockEeprom(), eeprom, sizeof(eeprom));
+  }
+
+/** Start up and check the values survived
+ */
+static void checkValues() {
+  uint8_t value[KV_VALUE_SIZE];
+  kvInit();
+  for(uint8_t key=0; key<KV_KEYS; key++) {
+    bool found = kvGet(key, value);
+    if(g_known[key]) {
+      CHECK(found);
+      CHECK((memcmp(value, g_stored[key], KV_VALUE_SIZE)==0)||
+        (g_changed[key]&&(memcmp(value, g_pending[key], KV_VALUE_SIZE)==0)));
+      }
+    else if(found)
+      CHECK(g_changed[key]&&(memcmp(value, g_pending[key], KV_VALUE_SIZE)==0));
+    // Whatever was loaded is now what is stored
+    g_known[key] = found;
+    memcpy(g_stored[key], value, KV_VALUE_SIZE);
+    g_changed[key] = false;
+    }
+  }
+
+/** Set a random value for a key
+ *
+ * Low numbered keys are changed more often so the others stay in their
+ * slots until the log wraps around and they have to be moved. A key is
+ * only changed once between checks so there is a single new value it can
+ * have.
+ */
+static void changeValue() {
+  uint8_t key = (rand() % KV_KEYS) & (rand() % KV_KEYS);
+  // Only one new value per key between checks
+  if(g_changed[key])
+    return;
+  for(uint8_t index=0; index<KV_VALUE_SIZE; index++)
+    g_pending[key][index] = rand();
+  kvSet(key, g_pending[key]);
+  g_changed[key] = true;
+  }
+
+/** Values survive power cuts at any point
+ */
+static void testPowerCut() {
+  srand(1);
+  mockReset();
+  for(uint16_t cycle=0; cycle<POWER_CYCLES; cycle++) {
+    checkValues();
+    sei();
+    // Sometimes let the writes finish first
+    if((rand() % 4)==0) {
+      for(uint8_t count=rand() % 4; count>0; count--)
+        changeValue();
+      kvFlush();
+      for(uint8_t key=0; key<KV_KEYS; key++) {
+        if(g_changed[key]) {
+          memcpy(g_stored[key], g_pending[key], KV_VALUE_SIZE);
+          g_known[key] = true;
+          g_changed[key] = false;
+          }
+        }
+      }
+    for(uint8_t count=(rand() % 3) + 1; count>0; count--)
+      changeValue();
+    // Cut the power part way through
+    mockAdvance(rand() % (EEPROM_CYCLES * 2 * (KV_VALUE_SIZE + 4)));
+    powerCycle();
+    }
+  checkValues();
+  }
+
+/** A key whose only record is in the next slot survives being changed
+ *
+ * Fills the log so the next slot to be written holds the only record for a
+ * key, then changes that key and cuts the power at every stage of the
+ * write that follows.
+ */
+static void testHeadSlot() {
+  static uint8_t eeprom[512];
+  uint8_t value[KV_VALUE_SIZE], old[KV_VALUE_SIZE], next[KV_VALUE_SIZE];
+  mockReset();
+  kvInit();
+  sei();
+  memset(old, 0x11, sizeof(old));
+  memset(next, 0x22, sizeof(next));
+  kvSet(1, old);
+  kvFlush();
+  // Key 0 fills the rest of the log so the head is back at key 1
+  for(uint8_t slot=1; slot<KV_SLOTS; slot++) {
+    memset(value, slot, sizeof(value));
+    kvSet(0, value);
+    kvFlush();
+    }
+  cli();
+  memcpy(eeprom, mockEeprom(), sizeof(eeprom));
+  // Try every point in the following writes
+  for(uint32_t cut=0; cut<(EEPROM_CYCLES * 2 * (KV_VALUE_SIZE + 4)); cut+=(EEPROM_CYCLES / 3)) {
+    mockReset();
+    memcpy(mockEeprom(), eeprom, sizeof(eeprom));
+    kvInit();
+    sei();
+    kvSet(1, next);
+    mockAdvance(cut);
+    powerCycle();
+    kvInit();
+    CHECK(kvGet(1, value)&&
+      ((memcmp(value, old, KV_VALUE_SIZE)==0)||(memcmp(value, next, KV_VALUE_SIZE)==0)));
+    }
+  }
+
+/** Program entry point
+ */
+int main() {
+  testHeadSlot();
+  testPowerCut();
+  return CHECK_RESULT("kvstore_test");
+  }
@@ -0,0 +1,96 @@
+/*--------------------------------------------------------------------------*
+* Latency instrumentation tests
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Checks interrupts disabled periods are measured at any point in the timer
+* cycle, that nested sections only measure the outermost one and that
+* periods too long for the timer are reported as LATENCY_OVERFLOW instead of
+* wrapping to a smaller value.
+*--------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "systicks.h"
+#include "latency.h"
+#include "check.h"
+
+/** Measure a single interrupts disabled period
+ *
+ * @param offset the timer count to start at (or just after).
+ * @param counts the number of counts to keep interrupts disabled for.
+ *
+ * @return the measured period in CPU cycles (or LATENCY_OVERFLOW).
+ */
+static uint16_t measure(uint8_t offset, uint16_t counts) {
+  // Wait for the start position with interrupts enabled (the overflow
+  // handler may skip over the exact count)
+  sei();
+  while((uint8_t)(TICKS_TCNT - offset)>=16)
+    mockAdvance(1);
+  latencyReset();
+  LATENCY_CLI();
+  mockAdvance((uint32_t)counts * TICKS_FINE_CYCLES);
+  LATENCY_SEI();
+  return latencyMaxOff();
+  }
+
+/** Short periods are measured exactly wherever they start
+ */
+static void testShort() {
+  mockReset();
+  ticksInit();
+  for(uint16_t offset=0; offset<256; offset+=5) {
+    for(uint16_t counts=1; counts<120; counts+=9) {
+      uint16_t cycles = measure(offset, counts);
+      CHECK((cycles!=LATENCY_OVERFLOW)&&
+        (cycles>=(counts * TICKS_FINE_CYCLES))&&
+        (cycles<=(((counts + 2) * TICKS_FINE_CYCLES) + 16)));
+      }
+    }
+  cli();
+  }
+
+/** Periods of a full timer cycle or more never wrap to a small value
+ */
+static void testOverflow() {
+  mockReset();
+  ticksInit();
+  for(uint16_t offset=0; offset<256; offset+=7) {
+    for(uint16_t counts=256; counts<1200; counts+=37)
+      CHECK(measure(offset, counts)==LATENCY_OVERFLOW);
+    }
+  cli();
+  }
+
+/** Only the outermost saved section is measured
+ */
+static void testNested() {
+  mockReset();
+  ticksInit();
+  sei();
+  latencyReset();
+  LATENCY_SAVE(outer);
+  mockAdvance(50 * TICKS_FINE_CYCLES);
+  LATENCY_SAVE(inner);
+  mockAdvance(10 * TICKS_FINE_CYCLES);
+  LATENCY_RESTORE(inner);
+  CHECK(latencyMaxOff()==0);
+  CHECK(!(SREG & (1 << SREG_I)));
+  mockAdvance(50 * TICKS_FINE_CYCLES);
+  LATENCY_RESTORE(outer);
+  CHECK(SREG & (1 << SREG_I));
+  uint16_t cycles = latencyMaxOff();
+  CHECK((cycles>=(110 * TICKS_FINE_CYCLES))&&(cycles<=((112 * TICKS_FINE_CYCLES) + 16)));
+  cli();
+  }
+
+/** Program entry point
+ */
+int main() {
+  testShort();
+  testOverflow();
+  testNested();
+  return CHECK_RESULT("latency_test");
+  }
@@ -0,0 +1,149 @@
+/*--------------------------------------------------------------------------*
+* Register mock tests
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Checks the emulated peripherals behave like the chip - timer overflow
+* and the interrupt it raises, write one to clear interrupt flags, pin
+* change interrupts and EEPROM writes with the ready interrupt.
+*--------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "check.h"
+
+// EEPROM write time in cycles (3.4ms)
+#define EEPROM_CYCLES ((F_CPU / 10000UL) * 34UL)
+
+//! Interrupt counts
+static uint16_t g_timerCalls, g_pinCalls, g_eepromCalls;
+
+ISR(TIMER1_OVF_vect) {
+  g_timerCalls++;
+  }
+
+ISR(PCINT0_vect) {
+  g_pinCalls++;
+  }
+
+ISR(EE_RDY_vect) {
+  g_eepromCalls++;
+  EECR &= ~(1 << EERIE);
+  }
+
+/** Timer 1 counts at the prescaled rate and overflows every 256 counts
+ */
+static void testTimer() {
+  mockReset();
+  TCCR1 = (1 << CS12); // Divide by 8
+  mockAdvance(8 * 100);
+  CHECK(TCNT1>=99 && TCNT1<=101);
+  CHECK(!(TIFR & (1 << TOV1)));
+  mockAdvance(8 * 200);
+  CHECK(TIFR & (1 << TOV1));
+  // The overflow interrupt is taken and clears the flag
+  g_timerCalls = 0;
+  TIMSK = (1 << TOIE1);
+  sei();
+  mockAdvance(8 * 256 * 4);
+  cli();
+  CHECK(g_timerCalls>=4 && g_timerCalls<=5);
+  CHECK(!(TIFR & (1 << TOV1)));
+  }
+
+/** Interrupt flags are cleared by writing a one
+ */
+static void testClearFlags() {
+  mockReset();
+  TCCR1 = (1 << CS10); // No prescale
+  mockAdvance(300);
+  CHECK(TIFR & (1 << TOV1));
+  // Writing zero has no effect
+  TIFR = 0;
+  CHECK(TIFR & (1 << TOV1));
+  // Writing the flag back (the value just read) clears it
+  TIFR = (1 << TOV1);
+  CHECK(!(TIFR & (1 << TOV1)));
+  // A read modify write of another bit clears all the set flags
+  mockAdvance(300);
+  CHECK(TIFR & (1 << TOV1));
+  TIFR |= (1 << TOV0);
+  CHECK(!(TIFR & ((1 << TOV1) | (1 << TOV0))));
+  }
+
+/** Pin changes set the flag and call the handler when enabled
+ */
+static void testPinChange() {
+  mockReset();
+  mockPinInput(PINB3, true);
+  PCMSK = (1 << PINB3);
+  GIFR = (1 << PCIF);
+  CHECK(!(GIFR & (1 << PCIF)));
+  // Unmasked pins are ignored
+  mockPinInput(PINB4, true);
+  CHECK(!(GIFR & (1 << PCIF)));
+  // Masked pins set the flag
+  mockPinInput(PINB3, false);
+  CHECK(GIFR & (1 << PCIF));
+  CHECK(!(PINB & (1 << PINB3)));
+  GIFR = (1 << PCIF);
+  CHECK(!(GIFR & (1 << PCIF)));
+  // With the interrupt enabled the handler is called
+  g_pinCalls = 0;
+  GIMSK = (1 << PCIE);
+  sei();
+  mockPinInput(PINB3, true);
+  mockAdvance(10);
+  mockPinInput(PINB3, false);
+  mockAdvance(10);
+  cli();
+  CHECK(g_pinCalls==2);
+  CHECK(!(GIFR & (1 << PCIF)));
+  }
+
+/** EEPROM writes take the programming time and raise the ready interrupt
+ */
+static void testEeprom() {
+  mockReset();
+  CHECK(mockEeprom()[0x123]==0xFF);
+  EEARH = 0x01;
+  EEARL = 0x23;
+  EEDR = 0x5A;
+  EECR = (1 << EEMPE);
+  EECR |= (1 << EEPE);
+  // Busy until the write completes
+  mockAdvance(EEPROM_CYCLES / 2);
+  CHECK(EECR & (1 << EEPE));
+  CHECK(mockEeprom()[0x123]==0xFF);
+  mockAdvance(EEPROM_CYCLES);
+  CHECK(!(EECR & (1 << EEPE)));
+  CHECK(mockEeprom()[0x123]==0x5A);
+  // Read it back
+  EEDR = 0;
+  EECR |= (1 << EERE);
+  CHECK(EEDR==0x5A);
+  // Ready interrupt fires once the EEPROM is idle
+  g_eepromCalls = 0;
+  EEDR = 0xA5;
+  EECR = (1 << EEMPE);
+  EECR |= (1 << EEPE);
+  EECR |= (1 << EERIE);
+  sei();
+  mockAdvance(EEPROM_CYCLES / 2);
+  CHECK(g_eepromCalls==0);
+  mockAdvance(EEPROM_CYCLES);
+  cli();
+  CHECK(g_eepromCalls==1);
+  CHECK(mockEeprom()[0x123]==0xA5);
+  }
+
+/** Program entry point
+ */
+int main() {
+  testTimer();
+  testClearFlags();
+  testPinChange();
+  testEeprom();
+  return CHECK_RESULT("mock_test");
+  }
@@ -0,0 +1,189 @@
+/*--------------------------------------------------------------------------*
+* Packet protocol tests
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Sends packets through the mock UART and decodes them again - payloads
+* full of zeros, payloads long enough to need a full 254 byte block and
+* packets that are too large or have been damaged. When run with arguments
+* it encodes or decodes a single frame so packet_test.py can check the
+* results against tools/packet.py:
+*
+*   packet_test encode <hex payload>  - prints the frame in hex
+*   packet_test decode <hex data>     - prints each valid payload in hex
+*                                       followed by the error count
+*--------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../hardware.h"
+#include "utility.h"
+#include "packet.h"
+#include "check.h"
+
+// Largest frame (COBS adds one byte per 254, plus the delimiter)
+#define FRAME_SIZE (((PACKET_SIZE + 2) * 255) / 254 + 2)
+
+/** Feed data to the decoder
+ *
+ * @param pData the data to decode.
+ * @param length the number of bytes.
+ *
+ * @return the number of valid packets completed.
+ */
+static uint8_t feed(const uint8_t *pData, uint16_t length) {
+  uint8_t packets = 0;
+  for(uint16_t index=0; index<length; index++) {
+    if(packetFeed(pData[index]))
+      packets++;
+    }
+  return packets;
+  }
+
+/** Encode a payload
+ *
+ * @param pData the payload.
+ * @param length the number of bytes in the payload.
+ * @param pFrame receives the encoded frame.
+ *
+ * @return the length of the frame.
+ */
+static uint16_t encode(const uint8_t *pData, uint8_t length, uint8_t *pFrame) {
+  uint16_t size;
+  mockUartClear();
+  packetSend(pData, length);
+  const uint8_t *output = mockUartOutput(&size);
+  memcpy(pFrame, output, size);
+  return size;
+  }
+
+/** Check a payload survives the trip through the encoder and decoder
+ */
+static void roundTrip(const uint8_t *pData, uint8_t length) {
+  uint8_t frame[FRAME_SIZE];
+  uint16_t size = encode(pData, length, frame);
+  // Only the delimiter can be zero
+  CHECK(size>=(length + 4));
+  CHECK(memchr(frame, 0, size)==(frame + size - 1));
+  uint8_t errors = packetErrors();
+  CHECK(feed(frame, size)==1);
+  CHECK(packetErrors()==errors);
+  CHECK(packetLength()==length);
+  CHECK(memcmp(packetData(), pData, length)==0);
+  }
+
+/** Payloads with runs of zeros and no zeros at all
+ */
+static void testRoundTrip() {
+  uint8_t data[PACKET_SIZE];
+  mockReset();
+  // Empty payload
+  roundTrip(data, 0);
+  // All zeros (every block is empty)
+  memset(data, 0, sizeof(data));
+  for(uint16_t length=1; length<=PACKET_SIZE; length+=(length<8)?1:41)
+    roundTrip(data, length);
+  // No zeros at all, including lengths that need a full 254 byte block
+  for(uint16_t index=0; index<PACKET_SIZE; index++)
+    data[index] = (index % 255) + 1;
+  for(uint16_t length=1; length<=PACKET_SIZE; length+=(length<248)?41:1)
+    roundTrip(data, length);
+  // Random data with zeros scattered through it
+  srand(1);
+  for(uint16_t count=0; count<200; count++) {
+    uint8_t length = rand() % (PACKET_SIZE + 1);
+    for(uint8_t index=0; index<length; index++)
+      data[index] = (rand() & 1)?0:rand();
+    roundTrip(data, length);
+    }
+  }
+
+/** Damaged frames are rejected and counted
+ */
+static void testCrcFailure() {
+  uint8_t data[PACKET_SIZE], frame[FRAME_SIZE];
+  mockReset();
+  srand(2);
+  for(uint8_t index=0; index<PACKET_SIZE; index++)
+    data[index] = rand();
+  for(uint16_t count=0; count<200; count++) {
+    uint8_t length = rand() % (PACKET_SIZE + 1);
+    uint16_t size = encode(data, length, frame);
+    // Change a single data byte without adding a zero or changing the
+    // block structure
+    uint16_t pos = rand() % (size - 1);
+    uint16_t code = 0;
+    for(uint16_t block=0; block<=pos; block+=frame[block])
+      code = block;
+    if(pos==code)
+      continue;
+    frame[pos] = (frame[pos]==0xFF)?0x01:(frame[pos] + 1);
+    uint8_t errors = packetErrors();
+    CHECK(feed(frame, size)==0);
+    CHECK(packetErrors()==(errors + 1));
+    }
+  // A frame cut short loses only that packet
+  uint16_t size = encode(data, 20, frame);
+  uint8_t errors = packetErrors();
+  CHECK(feed(frame, size / 2)==0);
+  CHECK(feed(frame + size - 1, 1)==0);
+  CHECK(packetErrors()==(errors + 1));
+  CHECK(feed(frame, size)==1);
+  // Empty frames are ignored
+  CHECK(feed(frame + size - 1, 1)==0);
+  CHECK(packetErrors()==(errors + 1));
+  }
+
+/** Convert a hex string to bytes
+ *
+ * @return the number of bytes or -1 if the string is not valid.
+ */
+static int fromHex(const char *hex, uint8_t *pData, int size) {
+  int length = strlen(hex) / 2;
+  if(((strlen(hex) % 2)!=0)||(length>size))
+    return -1;
+  for(int index=0; index<length; index++) {
+    char digits[3] = { hex[index * 2], hex[(index * 2) + 1], 0 };
+    char *end;
+    pData[index] = strtol(digits, &end, 16);
+    if(*end!=0)
+      return -1;
+    }
+  return length;
+  }
+
+/** Print bytes in hex on a single line
+ */
+static void showHex(const uint8_t *pData, uint16_t length) {
+  for(uint16_t index=0; index<length; index++)
+    printf("%02X", pData[index]);
+  printf("\n");
+  }
+
+/** Program entry point
+ */
+int main(int argc, char *argv[]) {
+  static uint8_t data[4096];
+  if(argc==1) {
+    testRoundTrip();
+    testCrcFailure();
+    return CHECK_RESULT("packet_test");
+    }
+  int length = (argc==3)?fromHex(argv[2], data, sizeof(data)):-1;
+  if((length>=0)&&(strcmp(argv[1], "encode")==0)&&(length<=253)) {
+    uint8_t frame[((253 + 2) * 255) / 254 + 2];
+    showHex(frame, encode(data, length, frame));
+    return 0;
+    }
+  if((length>=0)&&(strcmp(argv[1], "decode")==0)) {
+    for(int index=0; index<length; index++) {
+      if(packetFeed(data[index]))
+        showHex(packetData(), packetLength());
+      }
+    printf("errors %d\n", packetErrors());
+    return 0;
+    }
+  printf("Usage: %s encode|decode <hex>\n", argv[0]);
+  return 1;
+  }
@@ -0,0 +1,131 @@
+#!/usr/bin/env python
+#----------------------------------------------------------------------------
+# 19-Oct-2026 ShaneG
+#
+# Checks the firmware packet encoder and decoder (through the packet_test
+# program) agree with tools/packet.py - payloads with runs of zeros, runs of
+# 254 bytes without a zero, packets too large for the receive buffer and
+# frames with a bad CRC.
+#----------------------------------------------------------------------------
+from os import path
+from sys import path as modules, exit
+from random import Random
+from subprocess import Popen, PIPE
+
+BASE_DIR = path.dirname(path.abspath(__file__))
+modules.insert(0, path.join(BASE_DIR, "..", "..", "tools"))
+from packet import packetEncode, packetDecode, PacketDecoder, MAX_SIZE
+
+#--- The firmware side
+PROGRAM = path.join(BASE_DIR, "obj", "packet_test")
+
+#--- Receive buffer size in the test build (see TEST_DEFINES)
+PACKET_SIZE = 253
+
+g_failures = 0
+
+def check(cond, message):
+  """ Report a failed check
+  """
+  global g_failures
+  if not cond:
+    print "packet_test.py: check failed: %s" % message
+    g_failures = g_failures + 1
+
+def firmware(command, data):
+  """ Run the firmware encoder or decoder on a string
+
+    Returns the output lines.
+  """
+  process = Popen([ PROGRAM, command, data.encode("hex") ], stdout = PIPE)
+  output = process.communicate()[0]
+  if process.returncode <> 0:
+    raise RuntimeError("%s failed" % PROGRAM)
+  return output.splitlines()
+
+def firmwareEncode(payload):
+  """ Encode a payload with the firmware
+  """
+  return firmware("encode", payload)[0].decode("hex")
+
+def firmwareDecode(data):
+  """ Decode a stream with the firmware
+
+    Returns a list of payloads and the number of errors.
+  """
+  lines = firmware("decode", data)
+  if not lines[-1].startswith("errors "):
+    raise RuntimeError("Unexpected output from %s" % PROGRAM)
+  return [ line.decode("hex") for line in lines[:-1] ], int(lines[-1][7:])
+
+def payloads():
+  """ Generate the payloads to test
+  """
+  random = Random(1)
+  yield ""
+  # Runs of zeros
+  for length in (1, 2, 3, 16, 252, 253):
+    yield "\x00" * length
+  # Runs of 254 bytes or more with no zeros (the CRC may add to the run)
+  for length in (251, 252, 253):
+    yield "".join([ chr((index % 255) + 1) for index in range(length) ])
+  # Zeros either side of a full block
+  yield "\x00" + ("\x55" * 252)
+  yield ("\xAA" * 252) + "\x00"
+  # Random data with scattered zeros
+  for count in range(50):
+    length = random.randint(0, MAX_SIZE)
+    yield "".join([ chr(random.choice((0, random.randint(1, 255)))) for index in range(length) ])
+
+def testRoundTrip():
+  """ Both encoders produce the same frame and both decoders accept it
+  """
+  for payload in payloads():
+    name = "%d byte payload" % len(payload)
+    frame = packetEncode(payload)
+    check(firmwareEncode(payload) == frame, "%s encoded differently" % name)
+    check(packetDecode(frame[:-1]) == payload, "%s not decoded by packet.py" % name)
+    check(firmwareDecode(frame) == ([ payload ], 0), "%s not decoded by firmware" % name)
+
+def testOversize():
+  """ Packets too large for the receive buffer are counted as errors
+  """
+  for length in (PACKET_SIZE + 1, 254, 300, 508):
+    payload = "\x5A" * length
+    frame = packetEncode(payload)
+    check(packetDecode(frame[:-1]) == payload, "%d byte payload not decoded by packet.py" % length)
+    check(firmwareDecode(frame) == ([], 1), "%d byte payload accepted by firmware" % length)
+  # The next packet is still received
+  frame = packetEncode("\x5A" * 300) + packetEncode("next")
+  check(firmwareDecode(frame) == ([ "next" ], 1), "packet after oversize packet lost")
+
+def testCrcFailure():
+  """ A frame with a damaged payload or CRC is rejected by both sides
+  """
+  random = Random(2)
+  for payload in payloads():
+    frame = packetEncode(payload)
+    # Corrupt a byte in the last block (never the code byte or delimiter)
+    last = 0
+    while (last + ord(frame[last])) < (len(frame) - 1):
+      last = last + ord(frame[last])
+    if ord(frame[last]) == 1:
+      continue
+    pos = random.randint(last + 1, len(frame) - 2)
+    damaged = frame[:pos] + chr((ord(frame[pos]) % 255) + 1) + frame[pos + 1:]
+    name = "%d byte payload damaged at %d" % (len(payload), pos)
+    check(packetDecode(damaged[:-1]) is None, "%s accepted by packet.py" % name)
+    check(firmwareDecode(damaged) == ([], 1), "%s accepted by firmware" % name)
+    # A stream with a damaged frame only loses that frame
+    decoder = PacketDecoder()
+    stream = frame + damaged + frame
+    check(decoder.feed(stream) == [ payload, payload ], "%s lost other packets in packet.py" % name)
+    check(decoder.errors == 1, "%s not counted by packet.py" % name)
+    check(firmwareDecode(stream) == ([ payload, payload ], 1), "%s lost other packets in firmware" % name)
+
+if __name__ == "__main__":
+  testRoundTrip()
+  testOversize()
+  testCrcFailure()
+  print "packet_test.py: %s" % ("FAILED" if g_failures else "passed")
+  exit(1 if g_failures else 0)
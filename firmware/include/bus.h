@@ -0,0 +1,68 @@
+/*--------------------------------------------------------------------------*
+* Multi-drop bus
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Addressed packets for many nodes sharing a single open drain line. Each
+* frame is a zero byte, the destination address and a packet (see
+* packet.h):
+*
+*   0x00 address COBS(payload crc_high crc_low) 0x00
+*
+* Addresses are 1 to 254 (0 can never appear there and BUS_BROADCAST goes
+* to every node). The address is checked in the receive interrupt so frames
+* for other nodes are never buffered. Nodes transmit with the line released
+* for a 1 bit and check it is really high, a node that sees a 0 instead has
+* lost the bus and stops immediately. Nodes can start up to a bit time
+* apart so the bits sent before the loser stopped may still damage the
+* start of the winning frame - receivers drop it as a bad packet (see
+* packetErrors()) without the sender knowing. Use an acknowledgement from
+* the receiver if delivery matters.
+*--------------------------------------------------------------------------*/
+#ifndef __BUS_H
+#define __BUS_H
+
+//--- Required definitions
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Address that every node accepts
+ */
+#define BUS_BROADCAST 0xFF
+
+/** Initialise the bus interface
+ *
+ * Sets up the UART and starts accepting frames for the given address. This
+ * replaces uartInit(). Use packetPoll() to receive frames, only those for
+ * this node (or broadcast) are seen.
+ *
+ * @param address the address of this node (1 to 254).
+ */
+void busInit(uint8_t address);
+
+/** Send a frame
+ *
+ * Waits for the bus to be idle for a character time and sends the frame.
+ * If another node wins the bus the frame is sent again once it is idle, up
+ * to BUS_RETRIES times. Each retry waits for a pseudo random number of
+ * extra bit times, from a sequence that depends on the node address, and
+ * the range doubles with each attempt so nodes that collided do not stay in
+ * step. Must be called with interrupts enabled.
+ *
+ * @param address the address to send to.
+ * @param pData pointer to the payload.
+ * @param length the number of bytes in the payload (max 253).
+ *
+ * @return true if this node did not see a collision while sending.
+ */
+bool busSend(uint8_t address, const uint8_t *pData, uint8_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BUS_H */
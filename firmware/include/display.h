@@ -0,0 +1,51 @@
+/*--------------------------------------------------------------------------*
+* Generic display interface
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Maps a common set of display functions on to the driver selected in
+* 'hardware.h' so application code can work with either the Nokia LCD or
+* the SSD1306 OLED. The mapping is done at compile time so there is no
+* additional code or call overhead.
+*--------------------------------------------------------------------------*/
+#ifndef __DISPLAY_H
+#define __DISPLAY_H
+
+//--- Required definitions
+#include "../hardware.h"
+
+#if defined(LCD_ENABLED) && defined(OLED_ENABLED)
+#  error "Only one display driver can be used through display.h"
+#elif defined(LCD_ENABLED)
+#  include "nokialcd.h"
+   /** Number of columns on the selected display */
+#  define DISPLAY_COL LCD_COL
+   /** Number of text rows on the selected display */
+#  define DISPLAY_ROW LCD_ROW
+#  define dispInit      lcdInit
+#  define dispClear     lcdClear
+#  define dispClearRow  lcdClearRow
+#  define dispPrintChar lcdPrintChar
+#  define dispPrint     lcdPrint
+#  define dispPrintP    lcdPrintP
+#  define dispImageP    lcdImageP
+#  define dispImageRleP lcdImageRleP
+#elif defined(OLED_ENABLED)
+#  include "ssd1306.h"
+   /** Number of columns on the selected display */
+#  define DISPLAY_COL OLED_COL
+   /** Number of text rows on the selected display */
+#  define DISPLAY_ROW OLED_ROW
+#  define dispInit      oledInit
+#  define dispClear     oledClear
+#  define dispClearRow  oledClearRow
+#  define dispPrintChar oledPrintChar
+#  define dispPrint     oledPrint
+#  define dispPrintP    oledPrintP
+#  define dispImageP    oledImageP
+#  define dispImageRleP oledImageRleP
+#else
+#  error "No display driver enabled in hardware.h"
+#endif
+
+#endif /* __DISPLAY_H */
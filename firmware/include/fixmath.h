@@ -0,0 +1,170 @@
+/*--------------------------------------------------------------------------*
+* Fixed point maths
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Integer and fixed point helpers for cores without a hardware multiplier.
+* The general functions are written in assembly language, the cycle counts
+* given do not include the call and return. Multiplication and division by
+* a constant are done inline with shifts and adds selected at compile time.
+*
+* As an example, scaling a 10 bit ADC reading to millivolts with a 5V
+* reference:
+*
+*   uint16_t mv = fixMulConst(adcRead(ADC1, 0, 1), 5000) >> 10;
+*--------------------------------------------------------------------------*/
+#ifndef __FIXMATH_H
+#define __FIXMATH_H
+
+//--- Required definitions
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Multiply two 8 bit values
+ *
+ * Takes 58 cycles.
+ *
+ * @param a the first value.
+ * @param b the second value.
+ *
+ * @return the 16 bit product.
+ */
+uint16_t fixMul8(uint8_t a, uint8_t b);
+
+/** Multiply two 16 bit values
+ *
+ * Takes 148 to 164 cycles (1 cycle extra for each bit set in b).
+ *
+ * @param a the first value.
+ * @param b the second value.
+ *
+ * @return the 32 bit product.
+ */
+uint32_t fixMul16(uint16_t a, uint16_t b);
+
+/** Integer square root of a 16 bit value
+ *
+ * Takes 171 to 187 cycles.
+ *
+ * @param value the value to find the square root of.
+ *
+ * @return the square root rounded down.
+ */
+uint8_t fixSqrt16(uint16_t value);
+
+/** Integer square root of a 32 bit value
+ *
+ * Takes 501 to 549 cycles.
+ *
+ * @param value the value to find the square root of.
+ *
+ * @return the square root rounded down.
+ */
+uint16_t fixSqrt32(uint32_t value);
+
+/** Sine of an angle
+ *
+ * Uses a 65 byte quarter wave table in PROGMEM. Takes 12 or 13 cycles plus
+ * loading the table address.
+ *
+ * @param angle the angle with a full circle being 256 units.
+ *
+ * @return the sine of the angle scaled to the range -127 to 127.
+ */
+int8_t fixSin(uint8_t angle);
+
+/** Cosine of an angle
+ *
+ * @param angle the angle with a full circle being 256 units.
+ *
+ * @return the cosine of the angle scaled to the range -127 to 127.
+ */
+#define fixCos(angle) fixSin((uint8_t)((angle) + 64))
+
+/** Base 2 logarithm
+ *
+ * The fraction comes from a 64 byte table in PROGMEM indexed by the six
+ * bits following the leading one, the error is less than 0.024. Takes 19
+ * cycles plus 6 for each leading zero bit (19 to 109) plus loading the
+ * table address.
+ *
+ * @param value the value to find the logarithm of.
+ *
+ * @return the logarithm as an 8.8 fixed point value (0 if value is 0).
+ */
+uint16_t fixLog2(uint16_t value);
+
+//---------------------------------------------------------------------------
+// Operations with constants
+//
+// These are expanded inline and rely on the constant argument being known
+// at compile time so that the unused steps are removed. The empty asm
+// statements stop the compiler turning the shifts and adds back into a call
+// to the library multiply.
+//---------------------------------------------------------------------------
+
+//! A single step of fixMulConst()
+#define FIX_MUL_STEP(n) \
+  if(k & (1U << (n))) \
+    result += shifted; \
+  if((uint32_t)k >> ((n) + 1)) { \
+    shifted <<= 1; \
+    asm("" : "+r" (shifted)); \
+    }
+
+/** Multiply by a constant
+ *
+ * Each bit up to the highest one set in the constant costs a 4 cycle shift
+ * and each bit that is set adds a 4 cycle add (so multiplying by 5000 takes
+ * about 70 cycles).
+ *
+ * @param value the value to multiply.
+ * @param k the constant to multiply by.
+ *
+ * @return the 32 bit product.
+ */
+static inline uint32_t fixMulConst(uint16_t value, uint16_t k) __attribute__ ((always_inline));
+static inline uint32_t fixMulConst(uint16_t value, uint16_t k) {
+  uint32_t shifted = value, result = 0;
+  FIX_MUL_STEP(0)  FIX_MUL_STEP(1)  FIX_MUL_STEP(2)  FIX_MUL_STEP(3)
+  FIX_MUL_STEP(4)  FIX_MUL_STEP(5)  FIX_MUL_STEP(6)  FIX_MUL_STEP(7)
+  FIX_MUL_STEP(8)  FIX_MUL_STEP(9)  FIX_MUL_STEP(10) FIX_MUL_STEP(11)
+  FIX_MUL_STEP(12) FIX_MUL_STEP(13) FIX_MUL_STEP(14) FIX_MUL_STEP(15)
+  return result;
+  }
+
+//! Number of bits needed to hold (d - 1) for the divisor d
+#define FIX_DIV_SHIFT(d) \
+  (((d)<=2)?1:((d)<=4)?2:((d)<=8)?3:((d)<=16)?4:((d)<=32)?5:((d)<=64)?6: \
+   ((d)<=128)?7:((d)<=256)?8:((d)<=512)?9:((d)<=1024)?10:((d)<=2048)?11: \
+   ((d)<=4096)?12:((d)<=8192)?13:((d)<=16384)?14:((d)<=32768)?15:16)
+
+/** Divide by a constant
+ *
+ * Multiplies by the reciprocal of the divisor instead of dividing. The
+ * result is exact for every 16 bit value. This costs a fixMulConst() by a
+ * 16 bit magic number plus about 20 cycles for the correction and shifts.
+ *
+ * @param value the value to divide.
+ * @param d the constant to divide by (must not be 0).
+ *
+ * @return the quotient rounded down.
+ */
+static inline uint16_t fixDivConst(uint16_t value, uint16_t d) __attribute__ ((always_inline));
+static inline uint16_t fixDivConst(uint16_t value, uint16_t d) {
+  if(d==1)
+    return value;
+  uint16_t magic = ((65536UL * ((1UL << FIX_DIV_SHIFT(d)) - d)) / d) + 1;
+  uint16_t high = fixMulConst(value, magic) >> 16;
+  return (high + ((value - high) >> 1)) >> (FIX_DIV_SHIFT(d) - 1);
+  }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FIXMATH_H */
@@ -0,0 +1,68 @@
+/*--------------------------------------------------------------------------*
+* Debounced input events
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Samples buttons on the system tick and queues press and release events
+* so the main loop does not have to poll the pins.
+*--------------------------------------------------------------------------*/
+#ifndef __INPUT_H
+#define __INPUT_H
+
+//--- Required definitions
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Value returned by inputNext() when the queue is empty
+ */
+#define INPUT_NONE  0xFF
+
+/** Flag set in an event for a press (clear for a release)
+ */
+#define INPUT_PRESS 0x80
+
+/** Mask to extract the pin number from an event
+ */
+#define INPUT_PIN   0x07
+
+/** Initialise input handling
+ *
+ * Sets the given pins as inputs with the pull up enabled. Inputs are active
+ * low (a button should connect the pin to ground). The pins are sampled on
+ * every system tick so the ticks system must be running (call ticksInit()
+ * or spwmInit()) and interrupts must be enabled.
+ *
+ * @param pins a bit mask of the pins to monitor (eg: (1 << PINB3)).
+ */
+void inputInit(uint8_t pins);
+
+/** Get the next input event
+ *
+ * @return the next event from the queue or INPUT_NONE if there are none.
+ *         The low bits hold the pin number and INPUT_PRESS is set if the
+ *         input was pressed, clear if it was released.
+ */
+uint8_t inputNext();
+
+/** Get the current debounced state of the inputs
+ *
+ * @return a bit mask with a bit set for each input that is pressed.
+ */
+uint8_t inputState();
+
+/** Sample the inputs
+ *
+ * Called from the system tick interrupt. An input must be stable for four
+ * samples (about 65ms) before a change is reported.
+ */
+void inputTick();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INPUT_H */
@@ -93,6 +93,29 @@ void adcInit(ANALOG adc);
  */
 uint16_t adcRead(ANALOG adc, uint8_t skip, uint8_t average);
 
+/** Start a single conversion
+ *
+ * Selects the input and starts a conversion without waiting for it to
+ * finish. Use adcBusy() to see when the result is available and then read
+ * it with adcResult(). This lets other work (or other tasks, see TASK_ADC())
+ * run during the conversion.
+ *
+ * @param adc the ADC input to read.
+ */
+void adcStart(ANALOG adc);
+
+/** Determine if a conversion is in progress
+ *
+ * @return true if the conversion started by adcStart() has not finished.
+ */
+bool adcBusy();
+
+/** Get the result of the last conversion
+ *
+ * @return the 10 bit result of the last completed conversion.
+ */
+uint16_t adcResult();
+
 //---------------------------------------------------------------------------
 // Hardware PWM helpers
 //---------------------------------------------------------------------------
@@ -243,6 +266,105 @@ uint16_t sspiInLSB(uint8_t sck, uint8_t miso, uint8_t bits);
  */
 uint16_t sspiInOutLSB(uint8_t sck, uint8_t mosi, uint8_t miso, uint16_t data, uint8_t bits);
 
+//---------------------------------------------------------------------------
+// I2C (TWI) master using the USI
+//
+// Addresses are the 7 bit slave address, the read/write bit is added by the
+// functions. Each function performs a complete transaction (start to stop)
+// and returns false if the slave did not acknowledge its address or a byte
+// that was written to it.
+//---------------------------------------------------------------------------
+
+/** Initialise the I2C master
+ *
+ * Sets up the USI in two wire mode and releases both bus lines. The bus
+ * speed is set by TWI_SPEED in @ref hardware.h.
+ */
+void twiInit();
+
+/** Write a block of data to a slave
+ *
+ * @param addr the 7 bit address of the slave.
+ * @param data pointer to the data to send.
+ * @param length the number of bytes to send.
+ *
+ * @return true if all bytes were acknowledged.
+ */
+bool twiWrite(uint8_t addr, const uint8_t *data, uint8_t length);
+
+/** Read a block of data from a slave
+ *
+ * All bytes except the last are acknowledged. Nothing is sent on the bus
+ * if the length is zero.
+ *
+ * @param addr the 7 bit address of the slave.
+ * @param data pointer to the buffer to receive the data.
+ * @param length the number of bytes to read.
+ *
+ * @return true if the slave acknowledged the address (always true if the
+ *         length is zero).
+ */
+bool twiRead(uint8_t addr, uint8_t *data, uint8_t length);
+
+/** Write a block of data to a slave register
+ *
+ * Sends the register address followed by the data in a single transaction.
+ * Most devices will auto increment the register address for each byte.
+ *
+ * @param addr the 7 bit address of the slave.
+ * @param reg the register address to write to.
+ * @param data pointer to the data to send.
+ * @param length the number of bytes to send.
+ *
+ * @return true if all bytes were acknowledged.
+ */
+bool twiWriteReg(uint8_t addr, uint8_t reg, const uint8_t *data, uint8_t length);
+
+/** Read a block of data from a slave register
+ *
+ * Sends the register address then uses a repeated start to read the data so
+ * the whole operation is a single transaction. If the length is zero only
+ * the register address is sent.
+ *
+ * @param addr the 7 bit address of the slave.
+ * @param reg the register address to read from.
+ * @param data pointer to the buffer to receive the data.
+ * @param length the number of bytes to read.
+ *
+ * @return true if the slave acknowledged the address and register.
+ */
+bool twiReadReg(uint8_t addr, uint8_t reg, uint8_t *data, uint8_t length);
+
+//---------------------------------------------------------------------------
+// I2C (TWI) slave using the USI (requires TWI_SLAVE_ENABLED)
+//
+// All bus activity is handled by the USI interrupts, the main program just
+// reads and updates the register values.
+//---------------------------------------------------------------------------
+
+/** Initialise the I2C slave
+ *
+ * Sets up the USI to wait for a start condition and clears the registers.
+ * The address and number of registers are set in @ref hardware.h. Interrupts
+ * must be enabled for the slave to respond.
+ */
+void twiSlaveInit();
+
+/** Get the current value of a slave register
+ *
+ * @param reg the register number.
+ *
+ * @return the current value of the register (0 for an invalid register).
+ */
+uint8_t twiRegGet(uint8_t reg);
+
+/** Set the value of a slave register
+ *
+ * @param reg the register number. Invalid registers are ignored.
+ * @param value the new value for the register.
+ */
+void twiRegSet(uint8_t reg, uint8_t value);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,70 @@
+/*--------------------------------------------------------------------------*
+* EEPROM key/value store
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Persistent storage for a small number of fixed size values with wear
+* leveling and background writes.
+*--------------------------------------------------------------------------*/
+#ifndef __KVSTORE_H
+#define __KVSTORE_H
+
+//--- Required definitions
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Initialise the key/value store
+ *
+ * Scans the EEPROM log and loads the most recent valid value for each key
+ * into RAM. Records with a bad CRC (from an interrupted write, for example)
+ * are ignored. This must be called before any other store function.
+ */
+void kvInit();
+
+/** Get the value for a key
+ *
+ * Values are read from the RAM copy so this never waits for the EEPROM.
+ *
+ * @param key the key to read (0 to KV_KEYS - 1).
+ * @param value pointer to a buffer of KV_VALUE_SIZE bytes to receive the
+ *              value.
+ *
+ * @return true if the key has a value, false if it has never been set.
+ */
+bool kvGet(uint8_t key, void *value);
+
+/** Set the value for a key
+ *
+ * The RAM copy is updated immediately and the value is written to EEPROM in
+ * the background (interrupts must be enabled). Setting a key to the value
+ * it already has does nothing and setting a key again before it has been
+ * written only results in a single write.
+ *
+ * @param key the key to set (0 to KV_KEYS - 1).
+ * @param value pointer to the KV_VALUE_SIZE bytes to store.
+ *
+ * @return true if the value was accepted.
+ */
+bool kvSet(uint8_t key, const void *value);
+
+/** Determine if there are writes in progress
+ *
+ * @return true if there are values waiting to be written to EEPROM.
+ */
+bool kvBusy();
+
+/** Wait for all pending writes to complete
+ *
+ * Use this before powering down or resetting. Interrupts must be enabled.
+ */
+void kvFlush();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __KVSTORE_H */
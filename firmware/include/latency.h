@@ -0,0 +1,128 @@
+/*--------------------------------------------------------------------------*
+* Interrupt latency instrumentation
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Measures how long the library keeps interrupts disabled and how long its
+* interrupt handlers run for. The worst case interrupt latency for a build
+* is the larger of the two values (plus the time taken by any handlers of
+* your own).
+*--------------------------------------------------------------------------*/
+#ifndef __LATENCY_H
+#define __LATENCY_H
+
+//--- Required definitions
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "../hardware.h"
+#include "systicks.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Value reported for periods that were too long to measure */
+#define LATENCY_OVERFLOW 0xFFFF
+
+/** Get the longest period interrupts were disabled
+ *
+ * @return the longest period (in CPU cycles) between LATENCY_CLI() and
+ *         LATENCY_SEI() (or LATENCY_SAVE() and LATENCY_RESTORE()) since the
+ *         last reset or LATENCY_OVERFLOW if a period was too long to
+ *         measure.
+ */
+uint16_t latencyMaxOff();
+
+/** Get the longest interrupt handler duration
+ *
+ * @return the longest time (in CPU cycles) spent in a handler that uses
+ *         LATENCY_ISR() since the last reset or LATENCY_OVERFLOW if a
+ *         handler ran for too long to measure.
+ */
+uint16_t latencyMaxIsr();
+
+/** Reset the recorded maximums
+ */
+void latencyReset();
+
+/** Start a measurement
+ *
+ * Captures the ticks timer count, clears the half way compare flag and
+ * records if an overflow is already pending. Used by the macros below.
+ *
+ * @return a value to pass to latencyOffEnd() or latencyIsrEnd().
+ */
+static inline uint16_t latencyStart() {
+  // The count must be read first (see latencyElapsed())
+  uint8_t count = TICKS_TCNT;
+  TICKS_TIFR = (1 << TICKS_OCF);
+  return ((TICKS_TIFR & (1 << TICKS_TOV))?0x100:0) | count;
+  }
+
+/** Finish measuring an interrupts disabled period
+ *
+ * @param start the value returned by latencyStart().
+ */
+void latencyOffEnd(uint16_t start);
+
+/** Finish measuring an interrupt handler
+ *
+ * Called automatically when the handler returns (see LATENCY_ISR()).
+ *
+ * @param start pointer to the value returned by latencyStart().
+ */
+void latencyIsrEnd(uint16_t *start);
+
+//---------------------------------------------------------------------------
+// Instrumentation macros
+//
+// When LATENCY_ENABLED is not defined in hardware.h these map directly to
+// cli(), sei() and the usual save and restore of SREG and LATENCY_ISR()
+// expands to nothing.
+//
+// Periods are measured with the ticks timer (TICKS_FINE_CYCLES resolution)
+// using the overflow flag and a compare flag set half way through the timer
+// cycle to detect wrapping. A period that runs for a full timer cycle (256
+// counts) or more is always recorded as LATENCY_OVERFLOW instead of a
+// smaller value. Periods below 128 counts are measured exactly unless they
+// start with a timer overflow pending, periods in between may be reported
+// either way. The compare unit of the ticks timer is used for this.
+// The system ticks must be running for the measurements to be valid.
+//
+// LATENCY_SAVE() and LATENCY_RESTORE() are for sections that may be entered
+// with interrupts already disabled, only the outermost section is measured.
+// LATENCY_ISR() adds about LATENCY_ISR_CYCLES to the handler entry time.
+//---------------------------------------------------------------------------
+
+//! Approximate cycles added to the start of a handler by LATENCY_ISR()
+#define LATENCY_ISR_CYCLES 20
+
+#if defined(LATENCY_ENABLED)
+   //! Time stamp for the current interrupts disabled period
+   extern uint16_t g_latencyOff;
+#  define LATENCY_CLI() do { cli(); g_latencyOff = latencyStart(); } while(0)
+#  define LATENCY_SEI() do { latencyOffEnd(g_latencyOff); sei(); } while(0)
+   // Critical section that restores the previous interrupt state
+#  define LATENCY_SAVE(sreg) \
+     uint8_t sreg = SREG; cli(); \
+     uint16_t sreg##Start = (sreg & (1 << SREG_I))?latencyStart():0
+#  define LATENCY_RESTORE(sreg) \
+     do { if(sreg & (1 << SREG_I)) latencyOffEnd(sreg##Start); SREG = sreg; } while(0)
+   // Place at the start of an ISR, the measurement ends on any return
+#  define LATENCY_ISR() \
+     uint16_t __latencyIsr __attribute__((cleanup(latencyIsrEnd), unused)) = latencyStart()
+#else
+#  define LATENCY_CLI() cli()
+#  define LATENCY_SEI() sei()
+#  define LATENCY_SAVE(sreg) uint8_t sreg = SREG; cli()
+#  define LATENCY_RESTORE(sreg) SREG = sreg
+#  define LATENCY_ISR()
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LATENCY_H */
@@ -139,6 +139,94 @@ void lcdPrintP(uint8_t row, uint8_t col, const char *str, bool invert);
  */
 void lcdImageP(uint8_t row, uint8_t col, const uint8_t *img, bool invert);
 
+/** Display a run length compressed graphic on the display
+ *
+ * This function displays graphics generated by 'tools/lcdimage.py --rle'.
+ * The first two bytes of the graphic are the height (in 8 pixel rows) and
+ * the width (in pixel columns), allowing images up to the full size of the
+ * display. The remaining data is the same sequence of 8 pixel vertical strips
+ * used by lcdImageP() compressed as a series of packets. Each packet starts
+ * with a control byte - values from 0x00 to 0x7F are followed by (value + 1)
+ * literal bytes, values from 0x80 to 0xFF are followed by a single byte that
+ * is repeated ((value & 0x7F) + 3) times.
+ *
+ * The data is decoded directly to the display (see rle.h) so no RAM buffer
+ * is required. Images that will display off the edge of the screen are
+ * clipped, images with a width or height of zero are ignored.
+ *
+ * @param row the row number (0 to 5) to start the top left of the image.
+ * @param col the column number (0 to 83) to start the top left of the image.
+ * @param img pointer to the compressed image in PROGMEM.
+ * @param invert if true the pixel colors will be inverted.
+ */
+void lcdImageRleP(uint8_t row, uint8_t col, const uint8_t *img, bool invert);
+
+//---------------------------------------------------------------------------
+// Banded frame buffer (requires LCD_BAND_ENABLED)
+//
+// A full frame buffer for the display needs 504 bytes which will not fit in
+// the RAM available. Instead a 'band' of LCD_BAND_ROWS rows is kept in RAM
+// and the drawing primitives below render into it. Any pixels that fall
+// outside the current band are clipped. Each column tracks whether it has
+// changed since the last flush so only modified spans are sent to the LCD.
+//---------------------------------------------------------------------------
+
+/** Select the rows covered by the frame buffer band
+ *
+ * Sets the top row of the band and resets the band to the background color.
+ * The band assumes the display already shows the background color in these
+ * rows (after lcdClear() or lcdClearRow() for example) so nothing is marked
+ * as changed. Selecting the row and background that are already active
+ * does nothing, this lets a program keep redrawing the same band and only
+ * send the changes. Selecting a different row or background throws away
+ * any changes in the band that have not been sent with lcdFlush().
+ *
+ * @param row the row number (0 to 5) for the top of the band. The band is
+ *            moved up if it would extend past the bottom of the display.
+ * @param invert if true the background is black rather than white.
+ */
+void lcdBandSelect(uint8_t row, bool invert);
+
+/** Set or clear a single pixel in the band
+ *
+ * @param x the horizontal pixel position (0 to 83).
+ * @param y the vertical pixel position (0 to 47).
+ * @param on if true the pixel is set (black), otherwise it is cleared.
+ */
+void lcdPixel(uint8_t x, uint8_t y, bool on);
+
+/** Draw a line in the band
+ *
+ * Draws a line between the two end points (inclusive).
+ *
+ * @param x0 the horizontal position of the start point.
+ * @param y0 the vertical position of the start point.
+ * @param x1 the horizontal position of the end point.
+ * @param y1 the vertical position of the end point.
+ * @param on if true the pixels are set (black), otherwise they are cleared.
+ */
+void lcdLine(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool on);
+
+/** Draw a rectangle in the band
+ *
+ * @param x the horizontal position of the top left corner.
+ * @param y the vertical position of the top left corner.
+ * @param w the width of the rectangle in pixels.
+ * @param h the height of the rectangle in pixels.
+ * @param on if true the pixels are set (black), otherwise they are cleared.
+ * @param fill if true the rectangle is filled, otherwise only the outline
+ *             is drawn.
+ */
+void lcdRect(uint8_t x, uint8_t y, uint8_t w, uint8_t h, bool on, bool fill);
+
+/** Send the changes in the band to the display
+ *
+ * Transmits the columns that have changed since the last flush. Adjacent
+ * changed columns are sent as a single span and small gaps between spans are
+ * bridged when that is cheaper than setting a new address.
+ */
+void lcdFlush();
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -0,0 +1,92 @@
+/*--------------------------------------------------------------------------*
+* Packet protocol
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Framed binary packets over the software UART. Each packet is the payload
+* followed by a CRC-16/CCITT (polynomial 0x1021, initial value 0xFFFF) of
+* the payload, high byte first. This is encoded with COBS (Consistent
+* Overhead Byte Stuffing) so it contains no zero bytes and a single zero
+* byte marks the end of the packet:
+*
+*   COBS(payload crc_high crc_low) 0x00
+*
+* The receiver can synchronise on any zero byte so a corrupted or partial
+* packet only loses that packet.
+*--------------------------------------------------------------------------*/
+#ifndef __PACKET_H
+#define __PACKET_H
+
+//--- Required definitions
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** The packet delimiter
+ */
+#define PACKET_END 0x00
+
+/** Send a packet
+ *
+ * The payload is encoded and sent as it is read so no extra buffer space is
+ * needed.
+ *
+ * @param pData pointer to the payload.
+ * @param length the number of bytes in the payload (max 253).
+ */
+void packetSend(const uint8_t *pData, uint8_t length);
+
+/** Process a single received byte
+ *
+ * The byte is decoded and added to the CRC as it arrives so completing a
+ * packet only needs a comparison. Use this to feed data from a source other
+ * than the UART, otherwise use packetPoll().
+ *
+ * @param ch the byte received.
+ *
+ * @return true if the byte completed a valid packet. The packet is
+ *         available from packetData() until the next byte is processed.
+ */
+bool packetFeed(uint8_t ch);
+
+/** Check for a complete packet
+ *
+ * Processes any data waiting in the UART buffer without blocking. Call this
+ * often enough to stop the UART buffer overflowing (UART_BUFFER characters
+ * take about 0.7ms to arrive at 57600 baud). Requires the interrupt driven
+ * UART.
+ *
+ * @return true if a valid packet has been received. The packet is available
+ *         from packetData() until the next call.
+ */
+bool packetPoll();
+
+/** Get the payload of the last packet received
+ *
+ * @return pointer to the payload.
+ */
+const uint8_t *packetData();
+
+/** Get the length of the last packet received
+ *
+ * @return the number of bytes in the payload.
+ */
+uint8_t packetLength();
+
+/** Get the number of receive errors
+ *
+ * Counts packets discarded because the CRC did not match, they were too
+ * large for the buffer or the framing was broken. The count stops at 255.
+ *
+ * @return the number of errors since startup.
+ */
+uint8_t packetErrors();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PACKET_H */
@@ -0,0 +1,55 @@
+/*--------------------------------------------------------------------------*
+* Pin change interrupt dispatcher
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Shares the pin change interrupt between the UART and handlers of your own.
+*--------------------------------------------------------------------------*/
+#ifndef __PCINT_H
+#define __PCINT_H
+
+//--- Required definitions
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Pin change handler
+ *
+ * Called from the interrupt handler when a monitored pin changes state so
+ * it should be kept short.
+ *
+ * @param pin the pin that changed (PINB0 to PINB5).
+ * @param level the new state of the pin (true if high).
+ */
+typedef void (*PCINT_HANDLER)(uint8_t pin, bool level);
+
+/** Attach a handler to a pin
+ *
+ * Enables the pin change interrupt for the pin and calls the handler on
+ * every edge. The UART receive pin cannot be used when the UART is
+ * interrupt driven, it is always serviced first by the dispatcher.
+ *
+ * @param pin the pin to monitor (PINB0 to PINB5).
+ * @param handler the function to call when the pin changes.
+ *
+ * @return true if the handler was attached.
+ */
+bool pcintAttach(uint8_t pin, PCINT_HANDLER handler);
+
+/** Remove the handler for a pin
+ *
+ * Disables the pin change interrupt for the pin (unless the UART is using
+ * it).
+ *
+ * @param pin the pin to stop monitoring.
+ */
+void pcintDetach(uint8_t pin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PCINT_H */
@@ -0,0 +1,79 @@
+/*--------------------------------------------------------------------------*
+* Cycle profiler
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Measure how long regions of code take to run on the device.
+*--------------------------------------------------------------------------*/
+#ifndef __PROFILE_H
+#define __PROFILE_H
+
+//--- Required definitions
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Start timing a region
+ *
+ * Records the current time stamp (see ticksFine()) for the region. Use the
+ * PROFILE_BEGIN() macro rather than calling this directly so the call is
+ * removed when profiling is not enabled.
+ *
+ * @param id the region identifier (0 to PROFILE_REGIONS - 1).
+ */
+void profileBegin(uint8_t id);
+
+/** Finish timing a region
+ *
+ * Updates the count, total, minimum and maximum time for the region. Use
+ * the PROFILE_END() macro rather than calling this directly so the call is
+ * removed when profiling is not enabled.
+ *
+ * @param id the region identifier (0 to PROFILE_REGIONS - 1).
+ */
+void profileEnd(uint8_t id);
+
+/** Clear all profiling results
+ */
+void profileReset();
+
+/** Print the profiling results to the UART
+ *
+ * Prints a line for each region that has been used showing the region id,
+ * the number of times it was timed and the minimum, maximum and average time
+ * taken in CPU cycles.
+ */
+void profileDump();
+
+//---------------------------------------------------------------------------
+// Profiling macros
+//
+// Profiling is only included if PROFILE is defined (use 'make PROFILE=1'),
+// otherwise these expand to nothing. The measurements use ticksFine() so
+// the ticks system must be running. Results have a resolution of
+// TICKS_FINE_CYCLES and include a small fixed measurement overhead (time an
+// empty region to find out how much).
+// Regions may be used from interrupt handlers as long as each id is only
+// used from one context.
+//---------------------------------------------------------------------------
+
+#if defined(PROFILE)
+#  define PROFILE_BEGIN(id) profileBegin(id)
+#  define PROFILE_END(id)   profileEnd(id)
+#  define PROFILE_RESET()   profileReset()
+#  define PROFILE_DUMP()    profileDump()
+#else
+#  define PROFILE_BEGIN(id)
+#  define PROFILE_END(id)
+#  define PROFILE_RESET()
+#  define PROFILE_DUMP()
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PROFILE_H */
@@ -0,0 +1,64 @@
+/*--------------------------------------------------------------------------*
+* Run length compressed images
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Decoder for the images generated by 'tools/lcdimage.py --rle', shared by
+* the LCD and OLED drivers.
+*--------------------------------------------------------------------------*/
+#ifndef __RLE_H
+#define __RLE_H
+
+//--- Required definitions
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Decoder state
+ */
+typedef struct _RLE_STATE {
+  const uint8_t *img; //!< Next byte of compressed data (in PROGMEM)
+  uint8_t count;      //!< Bytes left in the current packet
+  uint8_t data;       //!< Value being repeated (for runs)
+  bool run;           //!< True if the current packet is a run
+  } RLE_STATE;
+
+/** Start decoding a compressed image
+ *
+ * Reads the image header. The first two bytes of the image are the height
+ * (in 8 pixel rows) and the width (in pixel columns). The remaining data is
+ * a series of packets, each starting with a control byte - values from 0x00
+ * to 0x7F are followed by (value + 1) literal bytes, values from 0x80 to
+ * 0xFF are followed by a single byte that is repeated ((value & 0x7F) + 3)
+ * times.
+ *
+ * @param pState the decoder state to initialise.
+ * @param img pointer to the compressed image in PROGMEM.
+ * @param pHeight receives the height of the image (in 8 pixel rows).
+ * @param pWidth receives the width of the image (in pixel columns).
+ *
+ * @return true if the image can be displayed, false if the width or height
+ *         is zero.
+ */
+bool rleStartP(RLE_STATE *pState, const uint8_t *img, uint8_t *pHeight, uint8_t *pWidth);
+
+/** Get the next byte of image data
+ *
+ * Bytes are returned in display order (the vertical strips of the first
+ * row from left to right, then the next row). The caller must not read more
+ * than height * width bytes.
+ *
+ * @param pState the decoder state.
+ *
+ * @return the next 8 pixel vertical strip.
+ */
+uint8_t rleNextP(RLE_STATE *pState);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RLE_H */
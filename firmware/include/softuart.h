@@ -12,6 +12,7 @@
 //--- Required definitions
 #include <stdint.h>
 #include <avr/pgmspace.h>
+#include "../hardware.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -54,6 +55,42 @@ uint8_t uartAvail();
  */
 char uartRecv();
 
+//---------------------------------------------------------------------------
+// Additional UART channels (see uart_channel.h)
+//
+// UART_CHANNELS(X) expands X(name, rx) for each enabled channel in the
+// order the pin change dispatcher services them. Each channel provides:
+//
+//   void nameInit()       - initialise the channel.
+//   void nameSend(ch)     - send a single character.
+//   uint8_t nameAvail()   - number of characters in the receive buffer.
+//   char nameRecv()       - receive a character (blocks until one arrives).
+//   void namePinChange()  - receive handler called by the dispatcher.
+//
+// To add a channel give it settings in 'hardware.h', an implementation
+// like uart1.c and an entry in the list below.
+//---------------------------------------------------------------------------
+
+#ifdef UART1_ENABLED
+#  define UART_CHANNEL1(X) X(uart1, UART1_RX)
+#else
+#  define UART_CHANNEL1(X)
+#endif
+
+/** All enabled channels
+ */
+#define UART_CHANNELS(X) UART_CHANNEL1(X)
+
+// Declare the functions for each channel
+#define UART_CHANNEL_DECLARE(name, rx) \
+  void name##Init(); \
+  void name##Send(char ch); \
+  uint8_t name##Avail(); \
+  char name##Recv(); \
+  void name##PinChange();
+
+UART_CHANNELS(UART_CHANNEL_DECLARE)
+
 //---------------------------------------------------------------------------
 // Basic output for data types.
 //---------------------------------------------------------------------------
@@ -0,0 +1,141 @@
+/*--------------------------------------------------------------------------*
+* SSD1306 OLED Interface
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Simple routines for controlling a 128 x 64 SSD1306 OLED over I2C.
+*--------------------------------------------------------------------------*/
+#ifndef __SSD1306_H
+#define __SSD1306_H
+
+//--- Required definitions
+#include <stdint.h>
+#include <stdbool.h>
+
+/** Number of columns */
+#define OLED_COL 128
+
+/** Number of text rows (display pages) */
+#define OLED_ROW 8
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Initialise the OLED
+ *
+ * Sets up the pins required to communicate with the display and then does
+ * the actual chipset initialisation. The pin numbers and I2C address to use
+ * are defined in @ref hardware.h.
+ */
+void oledInit();
+
+/** Send a command byte to the OLED
+ *
+ * Each call is a separate I2C transaction. The drawing functions below batch
+ * their commands and data so prefer those where possible.
+ *
+ * @param cmd the command byte to send.
+ */
+void oledCommand(uint8_t cmd);
+
+/** Clear the screen
+ *
+ * Clear the entire display.
+ *
+ * @param invert if true the colors are inverted and the screen will be filled
+ *               with white.
+ */
+void oledClear(bool invert);
+
+/** Clear a single row
+ *
+ * Clears a single character row from the left edge of the screen to the right.
+ *
+ * @param row the row number (0 to 7) to clear.
+ * @param invert if true the colors are inverted and the row will be filled
+ *               with white.
+ */
+void oledClearRow(uint8_t row, bool invert);
+
+/** Write a single character
+ *
+ * Display a single ASCII character at the position described by the row and
+ * column parameters. Note that the row indicates an 8 pixel high character
+ * row while the column represents individual pixels. Each character is 5
+ * pixels wide with a single column of spacing giving a total of 6 pixels.
+ *
+ * @param row the row number (0 to 7) to display the character.
+ * @param col the column position (0 to 127) for the start of the left side of
+ *            the character.
+ * @param ch  the character to display. If the character is out of range it
+ *            will be replaced with the '?' character.
+ * @param invert if true the colors are inverted and the character will be
+ *               displayed as black on white.
+ */
+void oledPrintChar(uint8_t row, uint8_t col, char ch, bool invert);
+
+/** Write a nul terminated string
+ *
+ * Display a string of ASCII characters at the position described by the row
+ * and column parameters. The string is sent in a single I2C transaction and
+ * will be clipped at the right edge of the display.
+ *
+ * @param row the row number (0 to 7) to display the string.
+ * @param col the column position (0 to 127) for the start of the left side of
+ *            the string.
+ * @param str the string to display. If a character in the string is out of
+ *            range it will be replaced with the '?' character.
+ * @param invert if true the colors are inverted and the characters will be
+ *               displayed as black on white.
+ */
+void oledPrint(uint8_t row, uint8_t col, const char *str, bool invert);
+
+/** Write a nul terminated string from PROGMEM
+ *
+ * Display a string of ASCII characters at the position described by the row
+ * and column parameters. The string is sent in a single I2C transaction and
+ * will be clipped at the right edge of the display.
+ *
+ * @param row the row number (0 to 7) to display the string.
+ * @param col the column position (0 to 127) for the start of the left side of
+ *            the string.
+ * @param str the string to display. If a character in the string is out of
+ *            range it will be replaced with the '?' character.
+ * @param invert if true the colors are inverted and the characters will be
+ *               displayed as black on white.
+ */
+void oledPrintP(uint8_t row, uint8_t col, const char *str, bool invert);
+
+/** Display an arbitrary graphic on the display
+ *
+ * Displays an image in the same format used by lcdImageP(). The whole image
+ * is sent in a single I2C transaction. Images that will display off the edge
+ * of the screen are clipped.
+ *
+ * @param row the row number (0 to 7) to start the top left of the image.
+ * @param col the column number (0 to 127) to start the top left of the image.
+ * @param img pointer to the image in PROGMEM.
+ * @param invert if true the pixel colors will be inverted.
+ */
+void oledImageP(uint8_t row, uint8_t col, const uint8_t *img, bool invert);
+
+/** Display a run length compressed graphic on the display
+ *
+ * Displays a compressed image in the same format used by lcdImageRleP(). The
+ * whole image is decoded and sent in a single I2C transaction. Images that
+ * will display off the edge of the screen are clipped, images with a width
+ * or height of zero are ignored.
+ *
+ * @param row the row number (0 to 7) to start the top left of the image.
+ * @param col the column number (0 to 127) to start the top left of the image.
+ * @param img pointer to the compressed image in PROGMEM.
+ * @param invert if true the pixel colors will be inverted.
+ */
+void oledImageRleP(uint8_t row, uint8_t col, const uint8_t *img, bool invert);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* __SSD1306_H */
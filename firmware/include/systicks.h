@@ -16,11 +16,64 @@
 extern "C" {
 #endif
 
+//--- Timer used for the ticks (TIMER1 on the ATtiny85, TIMER2 on the ATmega)
+#if defined(__AVR_ATmega8__)
+#  define TICKS_TIMER2
+#  define TICKS_TCNT  TCNT2
+#  define TICKS_TIFR  TIFR
+#  define TICKS_TOV   TOV2
+#  define TICKS_TIMSK TIMSK
+#  define TICKS_TOIE  TOIE2
+#  define TICKS_OCR   OCR2
+#  define TICKS_OCF   OCF2
+#  define TICKS_vect  TIMER2_OVF_vect
+#elif defined(__AVR_ATmega88__) || defined(__AVR_ATmega168__)
+#  define TICKS_TIMER2
+#  define TICKS_TCNT  TCNT2
+#  define TICKS_TIFR  TIFR2
+#  define TICKS_TOV   TOV2
+#  define TICKS_TIMSK TIMSK2
+#  define TICKS_TOIE  TOIE2
+#  define TICKS_OCR   OCR2A
+#  define TICKS_OCF   OCF2A
+#  define TICKS_vect  TIMER2_OVF_vect
+#else
+#  define TICKS_TCNT  TCNT1
+#  define TICKS_TIFR  TIFR
+#  define TICKS_TOV   TOV1
+#  define TICKS_TIMSK TIMSK
+#  define TICKS_TOIE  TOIE1
+#  define TICKS_OCR   OCR1A
+#  define TICKS_OCF   OCF1A
+#  define TICKS_vect  TIMER1_OVF_vect
+#endif
+
+/** Number of CPU cycles per ticksFine() count
+ *
+ * This is the timer prescaler. It is chosen for the clock profile so the
+ * timer counts at about 1MHz (the largest power of two not above F_CPU in
+ * MHz) which keeps the tick rate the same for every profile. TIMER2 on the
+ * ATmega has no divide by 16 or 4 so it counts at 2MHz at 16MHz and the
+ * tick rate doubles.
+ */
+#if (F_CPU >= 16000000) && !defined(TICKS_TIMER2)
+#  define TICKS_FINE_CYCLES 16
+#elif F_CPU >= 8000000
+#  define TICKS_FINE_CYCLES 8
+#elif (F_CPU >= 4000000) && !defined(TICKS_TIMER2)
+#  define TICKS_FINE_CYCLES 4
+#elif (F_CPU >= 2000000) && !defined(TICKS_TIMER2)
+#  define TICKS_FINE_CYCLES 2
+#else
+#  define TICKS_FINE_CYCLES 1
+#endif
+
 /** Number of ticks per second
  *
- * Defines the approximate number of ticks that occur every second.
+ * Defines the approximate number of ticks that occur every second. A tick
+ * is 64 timer overflows (61 ticks per second for the standard profiles).
  */
-#define TICKS_PER_SECOND 60
+#define TICKS_PER_SECOND (F_CPU / (TICKS_FINE_CYCLES * 256UL * 64UL))
 
 /** Initialise the 'ticks' subsystem.
  *
@@ -30,9 +83,9 @@ extern "C" {
  * tracked by a 16 bit counter. A program can use the difference between
  * samples of the counter to measure longer periods of time.
  *
- * The ticks system uses TIMER1 to provide the interrupt used to update the
- * time count (this interrupt is shared with the software PWM implementation
- * as well).
+ * The ticks system uses TIMER1 (TIMER2 on the ATmega parts) to provide the
+ * interrupt used to update the time count (this interrupt is shared with the
+ * software PWM implementation as well).
  */
 void ticksInit();
 
@@ -55,6 +108,34 @@ uint16_t ticks();
  */
 uint16_t ticksElapsed(uint16_t reference);
 
+/** Get a high resolution time stamp
+ *
+ * Combines the current ticks timer count with the number of overflows to give
+ * a 16 bit time stamp with a resolution of TICKS_FINE_CYCLES CPU cycles
+ * (1us for the standard clock profiles). The value wraps around every 65536
+ * counts (about 65ms) so it is only suitable for measuring short intervals.
+ * This is safe to call from interrupt handlers.
+ *
+ * The ticks system must be running (call ticksInit() or spwmInit() first).
+ *
+ * @return the current time stamp.
+ */
+uint16_t ticksFine();
+
+/** Sleep for a number of milliseconds
+ *
+ * Puts the CPU in idle mode between timer overflows until the requested
+ * time has elapsed. This uses far less power than wait() and other interrupts
+ * continue to be serviced during the delay. The resolution is one ticks timer
+ * overflow (256us for the standard clock profiles).
+ *
+ * The ticks system must be running (call ticksInit() or spwmInit() first)
+ * and interrupts must be enabled, if not this falls back to wait().
+ *
+ * @param millis the number of milliseconds to sleep for.
+ */
+void sleepMs(uint16_t millis);
+
 #ifdef __cplusplus
 }
 #endif
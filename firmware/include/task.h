@@ -0,0 +1,200 @@
+/*--------------------------------------------------------------------------*
+* Cooperative tasks
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Stackless cooperative tasks in the style of protothreads. Each task is an
+* ordinary function that can block on a condition (a character from the
+* UART, a number of ticks, an ADC conversion) and continue from the same
+* place the next time it is called. All tasks share the one stack so the
+* only RAM used is the 4 byte TASK structure for each of them.
+*
+* A task looks like this:
+*
+*   static uint8_t blink(TASK *pTask) {
+*     TASK_BEGIN(pTask);
+*     while(true) {
+*       pinToggle(PINB3);
+*       TASK_DELAY(pTask, TICKS_PER_SECOND / 2);
+*       }
+*     TASK_END(pTask);
+*     }
+*
+* Because the task function returns every time it blocks local variables
+* do not keep their values across a wait - use static variables (or fields
+* in a structure passed in with the task) for anything that must survive.
+* The wait macros record their position with __LINE__ so there can only be
+* one of them on each source line and a task cannot contain a switch
+* statement that spans a wait.
+*
+* The library functions themselves still busy wait, the TASK_RECV() and
+* TASK_ADC() macros only call them once they are guaranteed to return
+* immediately.
+*--------------------------------------------------------------------------*/
+#ifndef __TASK_H
+#define __TASK_H
+
+//--- Required definitions
+#include <stdint.h>
+#include <stdbool.h>
+#include "systicks.h"
+#include "softuart.h"
+#include "iohelp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Task state
+ */
+typedef struct _TASK {
+  uint16_t resume; //!< Line number to continue from (0 to start)
+  uint16_t timer;  //!< Tick count at the start of TASK_DELAY()
+  } TASK;
+
+//---------------------------------------------------------------------------
+// Task function results
+//---------------------------------------------------------------------------
+
+/** The task is blocked waiting for a condition */
+#define TASK_WAITING 0
+
+/** The task gave up the CPU but is ready to run again */
+#define TASK_YIELDED 1
+
+/** The task has finished (it will not run again until re-initialised) */
+#define TASK_EXITED  2
+
+/** Task function
+ *
+ * Called repeatedly by taskRun() (or your own loop) with the state for the
+ * task. Returns one of the TASK_xxx values above, the TASK_xxx macros take
+ * care of this.
+ */
+typedef uint8_t (*TASK_FUNC)(TASK *pTask);
+
+/** Resume value used to mark a finished task */
+#define TASK_FINISHED 0xFFFF
+
+//---------------------------------------------------------------------------
+// Task macros
+//---------------------------------------------------------------------------
+
+/** Initialise (or restart) a task
+ *
+ * @param pTask pointer to the TASK structure for the task.
+ */
+#define TASK_INIT(pTask) \
+  do { (pTask)->resume = 0; } while(0)
+
+/** Start of the task body
+ *
+ * Must be the first statement in the task function.
+ */
+#define TASK_BEGIN(pTask) \
+  switch((pTask)->resume) { case 0:
+
+/** End of the task body
+ *
+ * Must be the last statement in the task function. A task that reaches
+ * this point has finished and returns TASK_EXITED every time it is called.
+ */
+#define TASK_END(pTask) \
+  } (pTask)->resume = TASK_FINISHED; return TASK_EXITED
+
+/** Wait until a condition is true
+ *
+ * The condition is evaluated every time the task is called, the task
+ * continues with the next statement once it is true.
+ *
+ * @param pTask pointer to the TASK structure for the task.
+ * @param cond the condition to wait for.
+ */
+#define TASK_WAIT_UNTIL(pTask, cond) \
+  do { \
+    (pTask)->resume = __LINE__; case __LINE__: \
+    if(!(cond)) return TASK_WAITING; \
+    } while(0)
+
+/** Give up the CPU to the other tasks
+ *
+ * The task continues with the next statement when it is next called.
+ */
+#define TASK_YIELD(pTask) \
+  do { \
+    (pTask)->resume = __LINE__; return TASK_YIELDED; case __LINE__:; \
+    } while(0)
+
+/** Finish the task early
+ */
+#define TASK_EXIT(pTask) \
+  do { (pTask)->resume = TASK_FINISHED; return TASK_EXITED; } while(0)
+
+/** Wait for a number of system ticks
+ *
+ * There are TICKS_PER_SECOND ticks every second. The ticks system must be
+ * running (call ticksInit() or spwmInit() first).
+ *
+ * @param pTask pointer to the TASK structure for the task.
+ * @param count the number of ticks to wait for.
+ */
+#define TASK_DELAY(pTask, count) \
+  do { \
+    (pTask)->timer = ticks(); \
+    TASK_WAIT_UNTIL(pTask, ticksElapsed((pTask)->timer) >= (count)); \
+    } while(0)
+
+/** Wait for a character from the UART
+ *
+ * Requires the interrupt driven UART (or the hardware USART on the ATmega
+ * parts), uartAvail() is always zero for the polled implementation.
+ *
+ * @param pTask pointer to the TASK structure for the task.
+ * @param ch the char variable to store the received character in.
+ */
+#define TASK_RECV(pTask, ch) \
+  do { \
+    TASK_WAIT_UNTIL(pTask, uartAvail()); \
+    ch = uartRecv(); \
+    } while(0)
+
+/** Wait for an analog conversion
+ *
+ * Starts a single conversion on the given input (see adcStart()) and lets
+ * the other tasks run until it completes. Only one task can use the ADC at
+ * a time.
+ *
+ * @param pTask pointer to the TASK structure for the task.
+ * @param adc the ADC input to read.
+ * @param value the uint16_t variable to store the 10 bit result in.
+ */
+#define TASK_ADC(pTask, adc, value) \
+  do { \
+    adcStart(adc); \
+    TASK_WAIT_UNTIL(pTask, !adcBusy()); \
+    value = adcResult(); \
+    } while(0)
+
+//---------------------------------------------------------------------------
+// Scheduler
+//---------------------------------------------------------------------------
+
+/** Run a set of tasks
+ *
+ * Initialises the tasks and calls each of them in turn until they have all
+ * finished. When a complete pass finds every task waiting the CPU is put
+ * in idle mode until the next interrupt (with TASK_IDLE_SLEEP defined and
+ * the ticks system running). A condition set outside an interrupt handler
+ * is seen on the next timer overflow (every 256us at 8MHz).
+ *
+ * @param pFuncs the task functions.
+ * @param pTasks the state for each task (one entry for each function).
+ * @param count the number of tasks.
+ */
+void taskRun(const TASK_FUNC *pFuncs, TASK *pTasks, uint8_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TASK_H */
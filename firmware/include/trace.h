@@ -0,0 +1,66 @@
+/*--------------------------------------------------------------------------*
+* Event tracing
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Low overhead, time stamped event records for debugging timing problems.
+*--------------------------------------------------------------------------*/
+#ifndef __TRACE_H
+#define __TRACE_H
+
+//--- Required definitions
+#include <stdint.h>
+#include <stdbool.h>
+#include "../hardware.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Add a record to the trace buffer
+ *
+ * Stores the id and value along with the current time stamp (see
+ * ticksFine()). This is safe to call from interrupt handlers. If the buffer
+ * is full the record is discarded and counted as dropped. Use the TRACE()
+ * macro rather than calling this directly so the call is removed when
+ * tracing is not enabled.
+ *
+ * @param id an identifier for the event.
+ * @param value a value associated with the event.
+ */
+void traceAdd(uint8_t id, uint8_t value);
+
+/** Send all buffered records over the UART
+ *
+ * The records are sent as a single binary frame and removed from the buffer.
+ * The frame format is:
+ *
+ *   'T' 'R' count dropped [id value stamp_low stamp_high] * count crc_high crc_low
+ *
+ * Where 'dropped' is the number of records discarded since the last frame
+ * (up to 255) and the CRC (see crcByte()) covers the count, dropped and
+ * record bytes. Nothing is sent if the buffer is empty and no records have
+ * been dropped.
+ *
+ * @return the number of records sent.
+ */
+uint8_t traceDrain();
+
+/** Add a trace record
+ *
+ * Expands to nothing unless TRACE_ENABLED is defined in hardware.h.
+ *
+ * @param id an identifier for the event.
+ * @param value a value associated with the event.
+ */
+#if defined(TRACE_ENABLED)
+#  define TRACE(id, value) traceAdd(id, value)
+#else
+#  define TRACE(id, value)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TRACE_H */
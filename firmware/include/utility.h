@@ -16,12 +16,44 @@
 extern "C" {
 #endif
 
-/** An inaccurate delay function
+/** Busy wait for an exact number of CPU cycles
  *
- * This function will delay for the given number of milliseconds. This is not
- * an accurate delay (interrupt activity will interfere with the timing and it
- * uses instruction timing approximations to consume the time) but should be
- * close enough for many purposes without having to revert to a timer interrupt.
+ * The number of cycles must be a compile time constant, the compiler will
+ * generate the exact instruction sequence required inline. Interrupts that
+ * occur during the delay will extend it so disable them if the timing is
+ * critical.
+ *
+ * @param cycles the number of CPU cycles to wait.
+ */
+#define delayCycles(cycles) \
+  __builtin_avr_delay_cycles(cycles)
+
+/** Busy wait for a number of microseconds
+ *
+ * The number of microseconds must be a compile time constant. The delay is
+ * rounded up to a whole number of CPU cycles.
+ *
+ * @param us the number of microseconds to wait.
+ */
+#define delayUs(us) \
+  delayCycles((uint32_t)(((F_CPU / 1000000.0) * (us)) + 0.999))
+
+/** Set the clock prescaler for F_CPU
+ *
+ * The clock source is chosen by the fuses - the 8MHz internal oscillator or
+ * the 16MHz PLL (a 16MHz crystal on the ATmega parts) when F_CPU is above
+ * 8MHz. This sets the prescaler so the CPU runs at F_CPU regardless of the
+ * CKDIV8 fuse. Call this before any other initialisation. The ATmega8 has
+ * no prescaler so this does nothing there, the fuses alone set the clock.
+ */
+void clockInit();
+
+/** A simple delay function
+ *
+ * This function will delay for the given number of milliseconds. Each
+ * millisecond is timed exactly but interrupt activity will extend the delay
+ * and the CPU is kept busy the whole time. For longer delays consider using
+ * sleepMs() instead.
  */
 void wait(uint16_t millis);
 
@@ -80,6 +112,35 @@ uint16_t crcData(uint16_t crc, const uint8_t *pData, uint8_t length);
  */
 uint16_t crcDataP(uint16_t crc, const uint8_t *pData, uint8_t length);
 
+//---------------------------------------------------------------------------
+// Stack usage measurement (requires STACK_CHECK_ENABLED in hardware.h)
+//---------------------------------------------------------------------------
+
+/** Value used to fill unused RAM at startup
+ */
+#define STACK_CANARY 0xC5
+
+/** Get the maximum stack depth reached so far
+ *
+ * All RAM between the end of the static data and the top of the stack is
+ * filled with STACK_CANARY before main() is called. This scans up from the
+ * end of the static data to find the first byte that has been overwritten.
+ * The result is a lower bound - a value that happened to be written as
+ * STACK_CANARY will not be seen.
+ *
+ * @return the largest number of bytes of stack used since reset.
+ */
+uint16_t ramHighWater();
+
+/** Get the smallest amount of free RAM seen so far
+ *
+ * This is the gap between the end of the static data and the deepest point
+ * the stack has reached since reset.
+ *
+ * @return the number of bytes of RAM that have never been used.
+ */
+uint16_t ramUnused();
+
 #ifdef __cplusplus
   }
 #endif
@@ -0,0 +1,52 @@
+/*--------------------------------------------------------------------------*
+* WS2812 / SK6812 LED strip driver
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Sends colour data to a strip of WS2812 (or compatible SK6812) LEDs on a
+* single pin. The data is three bytes per LED in the order green, red and
+* blue, taken directly from RAM or PROGMEM and optionally scaled by a
+* brightness value as it is sent so no second buffer is needed.
+*
+* Each bit is 10 cycles at 8MHz (20 at 16MHz), high for 375ns for a 0 and
+* 750ns for a 1. Interrupts are disabled while the data is sent. The LEDs
+* latch the new colours once the line has been low for 300us so leave at
+* least that long between updates.
+*--------------------------------------------------------------------------*/
+#ifndef __WS2812_H
+#define __WS2812_H
+
+//--- Required definitions
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Initialise the LED strip pin
+ *
+ * Sets the data pin as an output and drives it low.
+ */
+void ws2812Init();
+
+/** Send colour data from RAM
+ *
+ * @param pData pointer to the GRB data (3 bytes per LED).
+ * @param length the number of bytes to send.
+ * @param brightness scale applied to each byte (255 for full brightness).
+ */
+void ws2812Send(const uint8_t *pData, uint16_t length, uint8_t brightness);
+
+/** Send colour data from PROGMEM
+ *
+ * @param pData pointer to the GRB data (3 bytes per LED) in PROGMEM.
+ * @param length the number of bytes to send.
+ * @param brightness scale applied to each byte (255 for full brightness).
+ */
+void ws2812SendP(const uint8_t *pData, uint16_t length, uint8_t brightness);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __WS2812_H */
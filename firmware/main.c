@@ -19,6 +19,7 @@ void main() __attribute__ ((noreturn));
 /** Program entry point
  */
 void main() {
+  clockInit();
   spwmInit();
   sei();
   spwmOut(SPWM0, 64);  // 25% duty cycle
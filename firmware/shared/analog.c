@@ -8,6 +8,18 @@
 #include <avr/io.h>
 #include "iohelp.h"
 
+// ADC clock prescaler (ADPS bits) to keep the ADC clock between 50KHz and
+// 200KHz for the clock profile
+#if F_CPU >= 8000000
+#  define ADC_PRESCALE 7
+#elif F_CPU >= 4000000
+#  define ADC_PRESCALE 6
+#elif F_CPU >= 2000000
+#  define ADC_PRESCALE 5
+#else
+#  define ADC_PRESCALE 4
+#endif
+
 /** Initialise the specified analog pin
  *
  * This function initialises the ADC accessory as well as setting up the input
@@ -19,7 +31,7 @@
  */
 void adcInit(ANALOG adc) {
   // Make sure the ADC convertor is setup
-  ADCSRA = (1 << ADEN) | (1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0);
+  ADCSRA = (1 << ADEN) | ADC_PRESCALE;
   // Switch off digital for the appropriate pin
   uint8_t mask, didr;
   if(adc==ADC0) {
@@ -47,6 +59,17 @@ void adcInit(ANALOG adc) {
   DIDR0 |= didr;
   }
 
+/** Select the input for the next conversion
+ *
+ * @param adc the ADC input to select.
+ */
+static void adcSelect(ANALOG adc) {
+  uint8_t muxval = adc;
+  if(adc==ADC4) // Need 1.1V reference
+    muxval = 0x80 | adc;
+  ADMUX = muxval;
+  }
+
 /** Read a value from the analog input
  *
  * Read a 10 bit value from the specified input with option input skipping and
@@ -60,10 +83,7 @@ void adcInit(ANALOG adc) {
  */
 uint16_t adcRead(ANALOG adc, uint8_t skip, uint8_t average) {
   // Change the reference voltage and select input
-  uint8_t muxval = adc;
-  if(adc==ADC4) // Need 1.1V reference
-    muxval = 0x80 | adc;
-  ADMUX = muxval;
+  adcSelect(adc);
   // Start the conversion
   uint8_t count = skip + average;
   uint16_t value, total = 0;
@@ -82,3 +102,34 @@ uint16_t adcRead(ANALOG adc, uint8_t skip, uint8_t average) {
   return (total / average);
   }
 
+
+/** Start a single conversion
+ *
+ * Selects the input and starts a conversion without waiting for it to
+ * finish. Use adcBusy() to see when the result is available and then read
+ * it with adcResult(). This lets other work (or other tasks, see TASK_ADC())
+ * run during the conversion.
+ *
+ * @param adc the ADC input to read.
+ */
+void adcStart(ANALOG adc) {
+  adcSelect(adc);
+  ADCSRA |= (1 << ADSC);
+  }
+
+/** Determine if a conversion is in progress
+ *
+ * @return true if the conversion started by adcStart() has not finished.
+ */
+bool adcBusy() {
+  return (ADCSRA & (1 << ADSC))?true:false;
+  }
+
+/** Get the result of the last conversion
+ *
+ * @return the 10 bit result of the last completed conversion.
+ */
+uint16_t adcResult() {
+  uint16_t value = ADCL;
+  return value | (ADCH << 8);
+  }
@@ -0,0 +1,125 @@
+/*--------------------------------------------------------------------------*
+* Multi-drop bus implementation
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Framing for the multi-drop bus. The address filter is in the UART receive
+* interrupt (uart_recv.c) and the collision detection is in the transmit
+* loop (uart_send.c), this ties them to the packet layer.
+*--------------------------------------------------------------------------*/
+#include <avr/io.h>
+#include "../hardware.h"
+#include "uart_defs.h"
+#include "softuart.h"
+#include "utility.h"
+#include "packet.h"
+#include "bus.h"
+
+// Only if enabled
+#ifdef BUS_ENABLED
+
+// Sanity checks
+#if !defined(UART_ENABLED) || !defined(UART_ONEPIN) || !defined(UART_INTERRUPT)
+#  error "The bus requires the one pin UART with UART_INTERRUPT defined"
+#endif
+#ifndef PACKET_ENABLED
+#  error "The bus requires PACKET_ENABLED"
+#endif
+
+// Number of bit times the line must be high before it is idle
+#define BUS_IDLE_BITS 11
+
+// CPU cycles per bit
+#define BUS_BIT_CYCLES (F_CPU / BAUD_RATE)
+
+//! Address of this node
+uint8_t g_busAddress = BUS_BROADCAST;
+
+//! Receive filter state
+volatile uint8_t g_busState = BUS_IGNORE;
+
+//! Set by uartSend() when we lose the bus
+volatile bool g_busCollision = false;
+
+//! Backoff generator state (seeded with the address)
+static uint8_t g_busRandom = 1;
+
+/** Get the next backoff value
+ *
+ * An 8 bit xorshift generator (period 255) seeded with the full node
+ * address. Every address starts at a different point in the sequence so
+ * nodes that collided pick different delays, even if their addresses share
+ * the low bits.
+ *
+ * @return a pseudo random value from 1 to 255.
+ */
+static uint8_t busBackoff() {
+  g_busRandom ^= g_busRandom << 2;
+  g_busRandom ^= g_busRandom >> 5;
+  g_busRandom ^= g_busRandom << 5;
+  return g_busRandom;
+  }
+
+/** Wait for the bus to be idle
+ *
+ * @param extra additional bit times to wait after the line goes idle.
+ */
+static void busWaitIdle(uint8_t extra) {
+  // BUS_IDLE_BITS + extra can be more than 255
+  uint16_t count = 0;
+  while(count<(BUS_IDLE_BITS + extra)) {
+    if(PINB & (1 << UART_RX))
+      count++;
+    else
+      count = 0;
+    delayCycles(BUS_BIT_CYCLES);
+    }
+  }
+
+/** Initialise the bus interface
+ *
+ * Sets up the UART and starts accepting frames for the given address. This
+ * replaces uartInit(). Use packetPoll() to receive frames, only those for
+ * this node (or broadcast) are seen.
+ *
+ * @param address the address of this node (1 to 254).
+ */
+void busInit(uint8_t address) {
+  g_busAddress = address;
+  g_busRandom = address?address:1;
+  g_busState = BUS_IGNORE;
+  g_busCollision = false;
+  uartInit();
+  }
+
+/** Send a frame
+ *
+ * Waits for the bus to be idle for a character time and sends the frame.
+ * If another node wins the bus the frame is sent again once it is idle, up
+ * to BUS_RETRIES times. Each retry waits for a pseudo random number of
+ * extra bit times, from a sequence that depends on the node address, and
+ * the range doubles with each attempt so nodes that collided do not stay in
+ * step. Must be called with interrupts enabled.
+ *
+ * @param address the address to send to.
+ * @param pData pointer to the payload.
+ * @param length the number of bytes in the payload (max 253).
+ *
+ * @return true if this node did not see a collision while sending.
+ */
+bool busSend(uint8_t address, const uint8_t *pData, uint8_t length) {
+  for(uint8_t attempt=0; attempt<BUS_RETRIES; attempt++) {
+    // The backoff range doubles with each retry (up to 255 bit times)
+    busWaitIdle(attempt?(busBackoff() & ((attempt<7)?((2 << attempt) - 1):0xFF)):0);
+    g_busCollision = false;
+    uartSend(PACKET_END);
+    uartSend(address);
+    packetSend(pData, length);
+    if(!g_busCollision)
+      return true;
+    }
+  g_busCollision = false;
+  return false;
+  }
+
+#endif /* BUS_ENABLED */
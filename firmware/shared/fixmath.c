@@ -0,0 +1,393 @@
+/*--------------------------------------------------------------------------*
+* Fixed point maths implementation
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* The multiply routines are the shift and add loops from Atmel application
+* note AVR200, the square roots use the bit by bit method. The C versions at
+* the end of the file are used for host builds where the assembly language
+* is not available - they use the same algorithms.
+*--------------------------------------------------------------------------*/
+#include <avr/pgmspace.h>
+#include "fixmath.h"
+
+/** Quarter wave sine table
+ *
+ * Entry n is round(127 * sin(n * 2pi / 256)) for n = 0 to 64.
+ */
+static const uint8_t SINE_TABLE[] PROGMEM = {
+    0,   3,   6,   9,  12,  16,  19,  22,  25,  28,  31,  34,  37,  40,  43,
+   46,  49,  51,  54,  57,  60,  63,  65,  68,  71,  73,  76,  78,  81,  83,
+   85,  88,  90,  92,  94,  96,  98, 100, 102, 104, 106, 107, 109, 111, 112,
+  113, 115, 116, 117, 118, 120, 121, 122, 122, 123, 124, 125, 125, 126, 126,
+  126, 127, 127, 127, 127
+  };
+
+/** Logarithm fraction table
+ *
+ * Entry n is round(256 * log2(1 + n / 64)) for n = 0 to 63.
+ */
+static const uint8_t LOG_TABLE[] PROGMEM = {
+    0,   6,  11,  17,  22,  28,  33,  38,  44,  49,  54,  59,  63,  68,  73,
+   78,  82,  87,  92,  96, 100, 105, 109, 113, 118, 122, 126, 130, 134, 138,
+  142, 146, 150, 154, 157, 161, 165, 169, 172, 176, 179, 183, 186, 190, 193,
+  197, 200, 203, 207, 210, 213, 216, 220, 223, 226, 229, 232, 235, 238, 241,
+  244, 247, 250, 253
+  };
+
+#ifdef __AVR__
+
+/** Multiply two 8 bit values
+ *
+ * Takes 58 cycles.
+ *
+ * @param a the first value.
+ * @param b the second value.
+ *
+ * @return the 16 bit product.
+ */
+uint16_t fixMul8(uint8_t a, uint8_t b) {
+  uint16_t result;
+  uint8_t count;
+  // The multiplier (b) is shifted out of the low byte as the product is
+  // shifted in from the high byte.
+  asm volatile(
+    "  clr %B[result]           \n\t" // 1
+    "  ldi %[count], 8          \n\t" // 1
+    "  lsr %A[result]           \n\t" // 1
+    "1:                         \n\t"
+    "  brcc 2f                  \n\t" // 2 (or 1 + 1 for the add)
+    "  add %B[result], %[a]     \n\t"
+    "2:                         \n\t"
+    "  ror %B[result]           \n\t" // 1
+    "  ror %A[result]           \n\t" // 1
+    "  dec %[count]             \n\t" // 1
+    "  brne 1b                  \n\t" // 2 (1 on exit)
+    : [result] "=&r" (result),
+      [count] "=&d" (count)
+    : "0" ((uint16_t)b),
+      [a] "r" (a)
+    );
+  return result;
+  }
+
+/** Multiply two 16 bit values
+ *
+ * Takes 148 to 164 cycles (1 cycle extra for each bit set in b).
+ *
+ * @param a the first value.
+ * @param b the second value.
+ *
+ * @return the 32 bit product.
+ */
+uint32_t fixMul16(uint16_t a, uint16_t b) {
+  uint32_t result;
+  uint8_t count;
+  asm volatile(
+    "  clr %D[result]           \n\t" // 1
+    "  clr %C[result]           \n\t" // 1
+    "  ldi %[count], 16         \n\t" // 1
+    "  lsr %B[result]           \n\t" // 1
+    "  ror %A[result]           \n\t" // 1
+    "1:                         \n\t"
+    "  brcc 2f                  \n\t" // 2 (or 1 + 2 for the add)
+    "  add %C[result], %A[a]    \n\t"
+    "  adc %D[result], %B[a]    \n\t"
+    "2:                         \n\t"
+    "  ror %D[result]           \n\t" // 1
+    "  ror %C[result]           \n\t" // 1
+    "  ror %B[result]           \n\t" // 1
+    "  ror %A[result]           \n\t" // 1
+    "  dec %[count]             \n\t" // 1
+    "  brne 1b                  \n\t" // 2 (1 on exit)
+    : [result] "=&r" (result),
+      [count] "=&d" (count)
+    : "0" ((uint32_t)b),
+      [a] "r" (a)
+    );
+  return result;
+  }
+
+/** Integer square root of a 16 bit value
+ *
+ * Takes 171 to 187 cycles.
+ *
+ * @param value the value to find the square root of.
+ *
+ * @return the square root rounded down.
+ */
+uint8_t fixSqrt16(uint16_t value) {
+  uint8_t root, count;
+  uint16_t rem, test;
+  // Two bits of the value are moved into the remainder for each bit of the
+  // result. The result bit is set if the remainder is at least 4r + 1
+  // where r is the result so far.
+  asm volatile(
+    "  clr %[root]              \n\t" // 1
+    "  clr %A[rem]              \n\t" // 1
+    "  clr %B[rem]              \n\t" // 1
+    "  ldi %[count], 8          \n\t" // 1
+    "1:                         \n\t"
+    "  lsl %A[value]            \n\t" // 4
+    "  rol %B[value]            \n\t"
+    "  rol %A[rem]              \n\t"
+    "  rol %B[rem]              \n\t"
+    "  lsl %A[value]            \n\t" // 4
+    "  rol %B[value]            \n\t"
+    "  rol %A[rem]              \n\t"
+    "  rol %B[rem]              \n\t"
+    "  lsl %[root]              \n\t" // 1
+    "  mov %A[test], %[root]    \n\t" // 5
+    "  clr %B[test]             \n\t"
+    "  sec                      \n\t"
+    "  rol %A[test]             \n\t"
+    "  rol %B[test]             \n\t"
+    "  cp %A[rem], %A[test]     \n\t" // 2
+    "  cpc %B[rem], %B[test]    \n\t"
+    "  brlo 2f                  \n\t" // 2 (or 1 + 3 to set the bit)
+    "  sub %A[rem], %A[test]    \n\t"
+    "  sbc %B[rem], %B[test]    \n\t"
+    "  inc %[root]              \n\t"
+    "2:                         \n\t"
+    "  dec %[count]             \n\t" // 1
+    "  brne 1b                  \n\t" // 2 (1 on exit)
+    : [root] "=&r" (root),
+      [count] "=&d" (count),
+      [rem] "=&r" (rem),
+      [test] "=&r" (test),
+      [value] "+r" (value)
+    );
+  return root;
+  }
+
+/** Integer square root of a 32 bit value
+ *
+ * Takes 501 to 549 cycles.
+ *
+ * @param value the value to find the square root of.
+ *
+ * @return the square root rounded down.
+ */
+uint16_t fixSqrt32(uint32_t value) {
+  uint16_t root;
+  uint8_t count;
+  __uint24 rem, test;
+  // Same as fixSqrt16(), the remainder never needs more than 19 bits.
+  asm volatile(
+    "  clr %A[root]             \n\t" // 1
+    "  clr %B[root]             \n\t" // 1
+    "  clr %A[rem]              \n\t" // 1
+    "  clr %B[rem]              \n\t" // 1
+    "  clr %C[rem]              \n\t" // 1
+    "  ldi %[count], 16         \n\t" // 1
+    "1:                         \n\t"
+    "  lsl %A[value]            \n\t" // 7
+    "  rol %B[value]            \n\t"
+    "  rol %C[value]            \n\t"
+    "  rol %D[value]            \n\t"
+    "  rol %A[rem]              \n\t"
+    "  rol %B[rem]              \n\t"
+    "  rol %C[rem]              \n\t"
+    "  lsl %A[value]            \n\t" // 7
+    "  rol %B[value]            \n\t"
+    "  rol %C[value]            \n\t"
+    "  rol %D[value]            \n\t"
+    "  rol %A[rem]              \n\t"
+    "  rol %B[rem]              \n\t"
+    "  rol %C[rem]              \n\t"
+    "  lsl %A[root]             \n\t" // 2
+    "  rol %B[root]             \n\t"
+    "  mov %A[test], %A[root]   \n\t" // 7
+    "  mov %B[test], %B[root]   \n\t"
+    "  clr %C[test]             \n\t"
+    "  sec                      \n\t"
+    "  rol %A[test]             \n\t"
+    "  rol %B[test]             \n\t"
+    "  rol %C[test]             \n\t"
+    "  cp %A[rem], %A[test]     \n\t" // 3
+    "  cpc %B[rem], %B[test]    \n\t"
+    "  cpc %C[rem], %C[test]    \n\t"
+    "  brlo 2f                  \n\t" // 2 (or 1 + 4 to set the bit)
+    "  sub %A[rem], %A[test]    \n\t"
+    "  sbc %B[rem], %B[test]    \n\t"
+    "  sbc %C[rem], %C[test]    \n\t"
+    "  inc %A[root]             \n\t"
+    "2:                         \n\t"
+    "  dec %[count]             \n\t" // 1
+    "  brne 1b                  \n\t" // 2 (1 on exit)
+    : [root] "=&r" (root),
+      [count] "=&d" (count),
+      [rem] "=&r" (rem),
+      [test] "=&r" (test),
+      [value] "+r" (value)
+    );
+  return root;
+  }
+
+/** Sine of an angle
+ *
+ * Uses a 65 byte quarter wave table in PROGMEM. Takes 12 or 13 cycles plus
+ * loading the table address.
+ *
+ * @param angle the angle with a full circle being 256 units.
+ *
+ * @return the sine of the angle scaled to the range -127 to 127.
+ */
+int8_t fixSin(uint8_t angle) {
+  int8_t result;
+  uint8_t index;
+  const uint8_t *table = SINE_TABLE;
+  asm volatile(
+    "  mov %[index], %[angle]   \n\t" // 1
+    "  andi %[index], 0x3F      \n\t" // 1
+    "  sbrs %[angle], 6         \n\t" // 3 (or 2 + 2 for the second quarter)
+    "  rjmp 1f                  \n\t"
+    "  neg %[index]             \n\t"
+    "  subi %[index], -64       \n\t"
+    "1:                         \n\t"
+    "  add r30, %[index]        \n\t" // 2
+    "  adc r31, __zero_reg__    \n\t"
+    "  lpm %[result], Z         \n\t" // 3
+    "  sbrc %[angle], 7         \n\t" // 2
+    "  neg %[result]            \n\t"
+    : [result] "=&r" (result),
+      [index] "=&d" (index),
+      "+z" (table)
+    : [angle] "r" (angle)
+    );
+  return result;
+  }
+
+/** Base 2 logarithm
+ *
+ * The fraction comes from a 64 byte table in PROGMEM indexed by the six
+ * bits following the leading one, the error is less than 0.024. Takes 19
+ * cycles plus 6 for each leading zero bit (19 to 109) plus loading the
+ * table address.
+ *
+ * @param value the value to find the logarithm of.
+ *
+ * @return the logarithm as an 8.8 fixed point value (0 if value is 0).
+ */
+uint16_t fixLog2(uint16_t value) {
+  uint16_t result;
+  const uint8_t *table = LOG_TABLE;
+  asm volatile(
+    "  clr %A[result]           \n\t" // 1
+    "  ldi %B[result], 15       \n\t" // 1
+    "  cp %A[value], __zero_reg__ \n\t" // 2
+    "  cpc %B[value], __zero_reg__ \n\t"
+    "  breq 3f                  \n\t" // 1 (2 for zero)
+    "  rjmp 2f                  \n\t" // 2
+    "1:                         \n\t"
+    "  lsl %A[value]            \n\t" // 3 for each leading zero
+    "  rol %B[value]            \n\t"
+    "  dec %B[result]           \n\t"
+    "2:                         \n\t"
+    "  sbrs %B[value], 7        \n\t" // 2 (or 1 + 2 to shift again)
+    "  rjmp 1b                  \n\t"
+    "  mov %A[result], %B[value] \n\t" // 3
+    "  lsr %A[result]           \n\t"
+    "  andi %A[result], 0x3F    \n\t"
+    "  add r30, %A[result]      \n\t" // 2
+    "  adc r31, __zero_reg__    \n\t"
+    "  lpm %A[result], Z        \n\t" // 3
+    "  rjmp 4f                  \n\t" // 2
+    "3:                         \n\t"
+    "  clr %B[result]           \n\t"
+    "4:                         \n\t"
+    : [result] "=&d" (result),
+      [value] "+r" (value),
+      "+z" (table)
+    );
+  return result;
+  }
+
+#else /* __AVR__ */
+
+/** Multiply two 8 bit values
+ *
+ * @param a the first value.
+ * @param b the second value.
+ *
+ * @return the 16 bit product.
+ */
+uint16_t fixMul8(uint8_t a, uint8_t b) {
+  return (uint16_t)a * b;
+  }
+
+/** Multiply two 16 bit values
+ *
+ * @param a the first value.
+ * @param b the second value.
+ *
+ * @return the 32 bit product.
+ */
+uint32_t fixMul16(uint16_t a, uint16_t b) {
+  return (uint32_t)a * b;
+  }
+
+/** Integer square root of a 32 bit value
+ *
+ * @param value the value to find the square root of.
+ *
+ * @return the square root rounded down.
+ */
+uint16_t fixSqrt32(uint32_t value) {
+  uint32_t rem = 0, test;
+  uint16_t root = 0;
+  for(uint8_t count=0; count<16; count++) {
+    rem = (rem << 2) | (value >> 30);
+    value <<= 2;
+    root <<= 1;
+    test = ((uint32_t)root << 1) | 1;
+    if(rem>=test) {
+      rem -= test;
+      root++;
+      }
+    }
+  return root;
+  }
+
+/** Integer square root of a 16 bit value
+ *
+ * @param value the value to find the square root of.
+ *
+ * @return the square root rounded down.
+ */
+uint8_t fixSqrt16(uint16_t value) {
+  return fixSqrt32(value);
+  }
+
+/** Sine of an angle
+ *
+ * @param angle the angle with a full circle being 256 units.
+ *
+ * @return the sine of the angle scaled to the range -127 to 127.
+ */
+int8_t fixSin(uint8_t angle) {
+  uint8_t index = angle & 0x3F;
+  if(angle & 0x40)
+    index = 64 - index;
+  int8_t result = pgm_read_byte_near(SINE_TABLE + index);
+  return (angle & 0x80)?-result:result;
+  }
+
+/** Base 2 logarithm
+ *
+ * @param value the value to find the logarithm of.
+ *
+ * @return the logarithm as an 8.8 fixed point value (0 if value is 0).
+ */
+uint16_t fixLog2(uint16_t value) {
+  if(value==0)
+    return 0;
+  uint8_t exponent = 15;
+  while(!(value & 0x8000)) {
+    value <<= 1;
+    exponent--;
+    }
+  return ((uint16_t)exponent << 8) | pgm_read_byte_near(LOG_TABLE + ((value >> 9) & 0x3F));
+  }
+
+#endif /* __AVR__ */
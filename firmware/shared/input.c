@@ -0,0 +1,112 @@
+/*--------------------------------------------------------------------------*
+* Debounced input events implementation
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Inputs are debounced with a pair of 'vertical' counters - one bit of each
+* counter byte for each pin - so all the pins are handled at once with a
+* few logic operations. A pin has to read the same for four ticks in a row
+* before the debounced state changes.
+*--------------------------------------------------------------------------*/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "../hardware.h"
+#include "latency.h"
+#include "input.h"
+
+// Only if enabled
+#ifdef INPUT_ENABLED
+
+// Sanity checks
+#if (INPUT_QUEUE & (INPUT_QUEUE - 1)) != 0
+#  error "INPUT_QUEUE must be a power of two"
+#endif
+
+//! Pins being monitored
+static uint8_t g_inputs = 0;
+
+//! Debounced state (bit set for a pressed input)
+static volatile uint8_t g_state = 0;
+
+//! The vertical counters
+static uint8_t g_count0 = 0xFF;
+static uint8_t g_count1 = 0xFF;
+
+//! Event queue
+static uint8_t g_events[INPUT_QUEUE];
+static volatile uint8_t g_head = 0;
+static volatile uint8_t g_tail = 0;
+
+/** Initialise input handling
+ *
+ * Sets the given pins as inputs with the pull up enabled. Inputs are active
+ * low (a button should connect the pin to ground). The pins are sampled on
+ * every system tick so the ticks system must be running (call ticksInit()
+ * or spwmInit()) and interrupts must be enabled.
+ *
+ * @param pins a bit mask of the pins to monitor (eg: (1 << PINB3)).
+ */
+void inputInit(uint8_t pins) {
+  LATENCY_SAVE(sreg);
+  DDRB &= ~pins;
+  PORTB |= pins;
+  g_inputs = pins;
+  g_state = 0;
+  g_count0 = 0xFF;
+  g_count1 = 0xFF;
+  g_head = 0;
+  g_tail = 0;
+  LATENCY_RESTORE(sreg);
+  }
+
+/** Get the next input event
+ *
+ * @return the next event from the queue or INPUT_NONE if there are none.
+ *         The low bits hold the pin number and INPUT_PRESS is set if the
+ *         input was pressed, clear if it was released.
+ */
+uint8_t inputNext() {
+  if(g_head==g_tail)
+    return INPUT_NONE;
+  uint8_t event = g_events[g_tail];
+  g_tail = (g_tail + 1) & (INPUT_QUEUE - 1);
+  return event;
+  }
+
+/** Get the current debounced state of the inputs
+ *
+ * @return a bit mask with a bit set for each input that is pressed.
+ */
+uint8_t inputState() {
+  return g_state;
+  }
+
+/** Sample the inputs
+ *
+ * Called from the system tick interrupt. An input must be stable for four
+ * samples (about 65ms) before a change is reported.
+ */
+void inputTick() {
+  // Find the inputs that differ from the debounced state
+  uint8_t changed = g_state ^ (~PINB & g_inputs);
+  // Count down for those, reset the others
+  g_count0 = ~(g_count0 & changed);
+  g_count1 = g_count0 ^ (g_count1 & changed);
+  // Changes that have been stable long enough
+  changed &= g_count0 & g_count1;
+  if(changed==0)
+    return;
+  g_state ^= changed;
+  // Queue an event for each one (drop them if the queue is full)
+  for(uint8_t pin=0; changed; pin++, changed >>= 1) {
+    if(!(changed & 0x01))
+      continue;
+    uint8_t next = (g_head + 1) & (INPUT_QUEUE - 1);
+    if(next==g_tail)
+      continue;
+    g_events[g_head] = pin | ((g_state & (1 << pin))?INPUT_PRESS:0);
+    g_head = next;
+    }
+  }
+
+#endif /* INPUT_ENABLED */
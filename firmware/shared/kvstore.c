@@ -0,0 +1,316 @@
+/*--------------------------------------------------------------------------*
+* EEPROM key/value store implementation
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* The EEPROM area is divided into fixed size record slots used as a
+* circular log. Each record holds a sequence number, the key, the value and
+* a CRC of the key and value:
+*
+*   seq key value[KV_VALUE_SIZE] crc_high crc_low
+*
+* New records always go in the slot after the newest one so writes are
+* spread evenly over the whole area. The newest record is the last one in
+* an unbroken run of sequence numbers. The sequence number is written last
+* so an interrupted write never looks like the newest record.
+*
+* If the slot about to be used holds the only copy of a key it is written
+* again (with the next sequence number) before anything else. The record is
+* copied from the EEPROM, not the RAM value, so only the sequence number
+* changes (a single byte write) and a new value for that key always goes in
+* a different slot.
+*--------------------------------------------------------------------------*/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <string.h>
+#include "../hardware.h"
+#include "utility.h"
+#include "latency.h"
+#include "kvstore.h"
+
+// Only if enabled
+#ifdef KV_ENABLED
+
+// The ATmega8 uses the older names for the EEPROM control bits
+#ifndef EEPE
+#  define EEPE  EEWE
+#  define EEMPE EEMWE
+#endif
+
+// Record layout
+#define KV_SEQ       0
+#define KV_KEY       1
+#define KV_VALUE     2
+#define KV_CRC       (KV_VALUE + KV_VALUE_SIZE)
+#define KV_SLOT_SIZE (KV_CRC + 2)
+
+// Number of record slots
+#define KV_SLOTS (KV_EEPROM_SIZE / KV_SLOT_SIZE)
+
+// Marker for keys that have no record
+#define KV_NO_SLOT 0xFF
+
+// Sanity checks
+#if KV_SLOTS > 254
+#  error "Too many key/value slots, increase KV_VALUE_SIZE or reduce KV_EEPROM_SIZE"
+#endif
+#if KV_SLOTS <= KV_KEYS
+#  error "Not enough EEPROM for the number of keys defined"
+#endif
+
+//! RAM copy of the values
+static uint8_t g_values[KV_KEYS][KV_VALUE_SIZE];
+
+//! Slot holding the newest record for each key
+static volatile uint8_t g_slots[KV_KEYS];
+
+//! Keys waiting to be written (one bit per key)
+static volatile uint8_t g_dirty[(KV_KEYS + 7) / 8];
+
+//! Slot for the next record and its sequence number
+static uint8_t g_head;
+static uint8_t g_seq;
+
+//! The record being written
+static uint8_t g_record[KV_SLOT_SIZE];
+static uint8_t g_offset = KV_SLOT_SIZE;
+static bool g_writing = false;
+
+//---------------------------------------------------------------------------
+// Helper functions
+//---------------------------------------------------------------------------
+
+/** Read a byte from EEPROM
+ *
+ * @param address the EEPROM address to read.
+ *
+ * @return the byte at that address.
+ */
+static uint8_t eepromRead(uint16_t address) {
+  while(EECR & (1 << EEPE));
+  EEARH = address >> 8;
+  EEARL = address & 0xFF;
+  EECR |= (1 << EERE);
+  return EEDR;
+  }
+
+/** Start writing a byte to EEPROM
+ *
+ * Must be called with interrupts disabled and no write in progress.
+ *
+ * @param address the EEPROM address to write.
+ * @param data the value to write.
+ */
+static void eepromWrite(uint16_t address, uint8_t data) {
+  EEARH = address >> 8;
+  EEARL = address & 0xFF;
+  EEDR = data;
+  EECR = (EECR & (1 << EERIE)) | (1 << EEMPE);
+  EECR |= (1 << EEPE);
+  }
+
+/** Calculate the CRC for the record buffer
+ */
+static uint16_t recordCrc() {
+  return crcData(crcInit(), &g_record[KV_KEY], KV_CRC - KV_KEY);
+  }
+
+/** Read a record into the record buffer
+ *
+ * @param slot the slot to read.
+ *
+ * @return true if the slot contains a valid record.
+ */
+static bool recordRead(uint8_t slot) {
+  uint16_t address = KV_EEPROM_START + (slot * KV_SLOT_SIZE);
+  for(uint8_t index=0; index<KV_SLOT_SIZE; index++)
+    g_record[index] = eepromRead(address + index);
+  if(g_record[KV_KEY]>=KV_KEYS)
+    return false;
+  return recordCrc()==(((uint16_t)g_record[KV_CRC] << 8) | g_record[KV_CRC + 1]);
+  }
+
+/** Find the next slot in the ring
+ */
+static uint8_t nextSlot(uint8_t slot) {
+  return (slot==(KV_SLOTS - 1))?0:(slot + 1);
+  }
+
+/** Set up the next record to write
+ *
+ * Called from the interrupt handler once the previous record is complete.
+ *
+ * @return true if there is a record to write.
+ */
+static bool recordNext() {
+  uint8_t key, index;
+  // Anything to do ?
+  for(index=0; (index<sizeof(g_dirty))&&(g_dirty[index]==0); index++);
+  if(index==sizeof(g_dirty))
+    return false;
+  // Move the record in the head slot forward if it is still in use
+  for(key=0; (key<KV_KEYS)&&(g_slots[key]!=g_head); key++);
+  if(key<KV_KEYS) {
+    // Copy it from the EEPROM rather than RAM so only the sequence number
+    // changes. A new value for the key goes in a fresh slot later.
+    recordRead(g_head);
+    g_record[KV_SEQ] = g_seq;
+    }
+  else {
+    // Take the first dirty key
+    for(key=0; !(g_dirty[key / 8] & (1 << (key % 8))); key++);
+    g_dirty[key / 8] &= ~(1 << (key % 8));
+    // Build the record
+    g_record[KV_SEQ] = g_seq;
+    g_record[KV_KEY] = key;
+    memcpy(&g_record[KV_VALUE], g_values[key], KV_VALUE_SIZE);
+    uint16_t crc = recordCrc();
+    g_record[KV_CRC] = crc >> 8;
+    g_record[KV_CRC + 1] = crc & 0xFF;
+    }
+  g_offset = 0;
+  g_writing = true;
+  return true;
+  }
+
+//---------------------------------------------------------------------------
+// Public API
+//---------------------------------------------------------------------------
+
+/** Initialise the key/value store
+ *
+ * Scans the EEPROM log and loads the most recent valid value for each key
+ * into RAM. Records with a bad CRC (from an interrupted write, for example)
+ * are ignored. This must be called before any other store function.
+ */
+void kvInit() {
+  uint8_t slot, newest = KV_NO_SLOT;
+  for(slot=0; slot<KV_KEYS; slot++)
+    g_slots[slot] = KV_NO_SLOT;
+  memset((void *)g_dirty, 0, sizeof(g_dirty));
+  g_offset = KV_SLOT_SIZE;
+  g_writing = false;
+  // Find the newest record (the end of the run of sequence numbers)
+  for(slot=0; (slot<KV_SLOTS)&&(newest==KV_NO_SLOT); slot++) {
+    if(!recordRead(slot))
+      continue;
+    g_seq = g_record[KV_SEQ] + 1;
+    if(!recordRead(nextSlot(slot))||(g_record[KV_SEQ]!=g_seq))
+      newest = slot;
+    }
+  if(newest==KV_NO_SLOT) {
+    // Empty store
+    g_head = 0;
+    g_seq = 0;
+    return;
+    }
+  // Load everything from oldest to newest so the latest value wins
+  g_head = nextSlot(newest);
+  slot = g_head;
+  do {
+    if(recordRead(slot)) {
+      memcpy(g_values[g_record[KV_KEY]], &g_record[KV_VALUE], KV_VALUE_SIZE);
+      g_slots[g_record[KV_KEY]] = slot;
+      }
+    slot = nextSlot(slot);
+    }
+  while(slot!=g_head);
+  }
+
+/** Get the value for a key
+ *
+ * Values are read from the RAM copy so this never waits for the EEPROM.
+ *
+ * @param key the key to read (0 to KV_KEYS - 1).
+ * @param value pointer to a buffer of KV_VALUE_SIZE bytes to receive the
+ *              value.
+ *
+ * @return true if the key has a value, false if it has never been set.
+ */
+bool kvGet(uint8_t key, void *value) {
+  if((key>=KV_KEYS)||((g_slots[key]==KV_NO_SLOT)&&!(g_dirty[key / 8] & (1 << (key % 8)))))
+    return false;
+  LATENCY_SAVE(sreg);
+  memcpy(value, g_values[key], KV_VALUE_SIZE);
+  LATENCY_RESTORE(sreg);
+  return true;
+  }
+
+/** Set the value for a key
+ *
+ * The RAM copy is updated immediately and the value is written to EEPROM in
+ * the background (interrupts must be enabled). Setting a key to the value
+ * it already has does nothing and setting a key again before it has been
+ * written only results in a single write.
+ *
+ * @param key the key to set (0 to KV_KEYS - 1).
+ * @param value pointer to the KV_VALUE_SIZE bytes to store.
+ *
+ * @return true if the value was accepted.
+ */
+bool kvSet(uint8_t key, const void *value) {
+  if(key>=KV_KEYS)
+    return false;
+  LATENCY_SAVE(sreg);
+  bool known = (g_slots[key]!=KV_NO_SLOT)||(g_dirty[key / 8] & (1 << (key % 8)));
+  if(!known||(memcmp(g_values[key], value, KV_VALUE_SIZE)!=0)) {
+    memcpy(g_values[key], value, KV_VALUE_SIZE);
+    g_dirty[key / 8] |= (1 << (key % 8));
+    // Make sure the writer is running
+    EECR |= (1 << EERIE);
+    }
+  LATENCY_RESTORE(sreg);
+  return true;
+  }
+
+/** Determine if there are writes in progress
+ *
+ * @return true if there are values waiting to be written to EEPROM.
+ */
+bool kvBusy() {
+  return EECR & (1 << EERIE);
+  }
+
+/** Wait for all pending writes to complete
+ *
+ * Use this before powering down or resetting. Interrupts must be enabled.
+ */
+void kvFlush() {
+  while(kvBusy());
+  }
+
+/** EEPROM ready interrupt
+ *
+ * Writes the next byte of the current record, skipping bytes that already
+ * have the right value. The sequence number is written last.
+ */
+ISR(EE_RDY_vect) {
+  LATENCY_ISR();
+  while(true) {
+    if(g_offset<KV_SLOT_SIZE) {
+      // Write order is key, value, CRC then sequence number
+      uint8_t index = (g_offset==(KV_SLOT_SIZE - 1))?KV_SEQ:(g_offset + 1);
+      uint16_t address = KV_EEPROM_START + (g_head * KV_SLOT_SIZE) + index;
+      g_offset++;
+      if(eepromRead(address)!=g_record[index]) {
+        eepromWrite(address, g_record[index]);
+        return;
+        }
+      continue;
+      }
+    // Previous record is complete
+    if(g_writing) {
+      g_slots[g_record[KV_KEY]] = g_head;
+      g_head = nextSlot(g_head);
+      g_seq++;
+      g_writing = false;
+      }
+    if(!recordNext()) {
+      // Nothing left to do
+      EECR &= ~(1 << EERIE);
+      return;
+      }
+    }
+  }
+
+#endif /* KV_ENABLED */
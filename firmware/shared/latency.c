@@ -0,0 +1,136 @@
+/*--------------------------------------------------------------------------*
+* Interrupt latency instrumentation implementation
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Keeps track of the longest interrupts disabled period and the longest
+* interrupt handler run time seen by the instrumentation macros.
+*--------------------------------------------------------------------------*/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "../hardware.h"
+#include "systicks.h"
+#include "latency.h"
+
+// Only if enabled
+#ifdef LATENCY_ENABLED
+
+//! Time stamp for the current interrupts disabled period
+uint16_t g_latencyOff;
+
+//! Longest interrupts disabled period (in ticks timer counts)
+static volatile uint16_t g_maxOff = 0;
+
+//! Longest interrupt handler (in ticks timer counts)
+static volatile uint16_t g_maxIsr = 0;
+
+/** Calculate the time elapsed since a measurement started
+ *
+ * While interrupts are disabled the overflow flag (set at zero) and the
+ * compare flag (set at 0x80) each show if the count has passed that point
+ * at least once. If the flags do not match the points between the start
+ * and current count the timer has wrapped. If both points are in that range
+ * a wrap cannot be ruled out. Either way the period is too long to measure.
+ * If an overflow was already pending at the start only the compare flag is
+ * useful.
+ *
+ * The flags are read before the count so a point passed between the two
+ * reads is seen as a short period. The start count was read before the
+ * compare flag was cleared so the flag is never set by a point before the
+ * start.
+ *
+ * @param start the value returned by latencyStart().
+ *
+ * @return the elapsed time in ticks timer counts or LATENCY_OVERFLOW.
+ */
+static uint16_t latencyElapsed(uint16_t start) {
+  uint8_t flags = TICKS_TIFR;
+  uint8_t count = TICKS_TCNT;
+  uint8_t first = (uint8_t)start;
+  uint8_t elapsed = count - first;
+  bool pending = start & 0x100;
+  bool wrapped = count<first;
+  bool halfway = (uint8_t)(0x7F - first)<elapsed;
+  if(flags & (1 << TICKS_OCF)) {
+    if(!halfway||pending||(wrapped&&(flags & (1 << TICKS_TOV))))
+      return LATENCY_OVERFLOW;
+    }
+  if(!pending&&!wrapped&&(flags & (1 << TICKS_TOV)))
+    return LATENCY_OVERFLOW;
+  return elapsed;
+  }
+
+/** Convert a period to CPU cycles
+ *
+ * @param period the period in ticks timer counts or LATENCY_OVERFLOW.
+ *
+ * @return the period in CPU cycles or LATENCY_OVERFLOW.
+ */
+static uint16_t latencyCycles(uint16_t period) {
+  if(period==LATENCY_OVERFLOW)
+    return LATENCY_OVERFLOW;
+  return period * TICKS_FINE_CYCLES;
+  }
+
+/** Get the longest period interrupts were disabled
+ *
+ * @return the longest period (in CPU cycles) between LATENCY_CLI() and
+ *         LATENCY_SEI() (or LATENCY_SAVE() and LATENCY_RESTORE()) since the
+ *         last reset or LATENCY_OVERFLOW if a period was too long to
+ *         measure.
+ */
+uint16_t latencyMaxOff() {
+  uint8_t sreg = SREG;
+  cli();
+  uint16_t result = g_maxOff;
+  SREG = sreg;
+  return latencyCycles(result);
+  }
+
+/** Get the longest interrupt handler duration
+ *
+ * @return the longest time (in CPU cycles) spent in a handler that uses
+ *         LATENCY_ISR() since the last reset or LATENCY_OVERFLOW if a
+ *         handler ran for too long to measure.
+ */
+uint16_t latencyMaxIsr() {
+  uint8_t sreg = SREG;
+  cli();
+  uint16_t result = g_maxIsr;
+  SREG = sreg;
+  return latencyCycles(result);
+  }
+
+/** Reset the recorded maximums
+ */
+void latencyReset() {
+  uint8_t sreg = SREG;
+  cli();
+  g_maxOff = 0;
+  g_maxIsr = 0;
+  SREG = sreg;
+  }
+
+/** Finish measuring an interrupts disabled period
+ *
+ * @param start the value returned by latencyStart().
+ */
+void latencyOffEnd(uint16_t start) {
+  uint16_t elapsed = latencyElapsed(start);
+  if(elapsed>g_maxOff)
+    g_maxOff = elapsed;
+  }
+
+/** Finish measuring an interrupt handler
+ *
+ * Called automatically when the handler returns (see LATENCY_ISR()).
+ *
+ * @param start pointer to the value returned by latencyStart().
+ */
+void latencyIsrEnd(uint16_t *start) {
+  uint16_t elapsed = latencyElapsed(*start);
+  if(elapsed>g_maxIsr)
+    g_maxIsr = elapsed;
+  }
+
+#endif /* LATENCY_ENABLED */
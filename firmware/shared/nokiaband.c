@@ -0,0 +1,230 @@
+/*--------------------------------------------------------------------------*
+* Nokia LCD banded frame buffer
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Partial frame buffer for the Nokia LCD with per column change tracking.
+*--------------------------------------------------------------------------*/
+#include <avr/io.h>
+#include "../hardware.h"
+#include "nokialcd.h"
+
+// Only provide the functions if the driver and band are enabled
+#if defined(LCD_ENABLED) && defined(LCD_BAND_ENABLED)
+
+// Make sure the band size is sensible
+#if (LCD_BAND_ROWS < 1) || (LCD_BAND_ROWS > 2)
+#  error "LCD_BAND_ROWS must be 1 or 2"
+#endif
+
+// Number of bytes needed for the dirty bitmap of a single row
+#define DIRTY_BYTES ((LCD_COL + 7) / 8)
+
+// Largest gap of unchanged columns to send rather than setting a new address.
+// Setting the address costs two command bytes so anything up to two data
+// bytes is no more expensive.
+#define SPAN_GAP 2
+
+//! Pixel data for the band
+static uint8_t g_band[LCD_BAND_ROWS][LCD_COL];
+
+//! Columns changed since the last flush (one bit per column)
+static uint8_t g_dirty[LCD_BAND_ROWS][DIRTY_BYTES];
+
+//! The display row at the top of the band
+static uint8_t g_bandRow = 0xFF;
+
+//! Background color of the band
+static bool g_bandInvert = false;
+
+/** Determine if a column in the band has changed
+ *
+ * @param row the row within the band.
+ * @param col the column to check.
+ *
+ * @return true if the column needs to be sent to the display.
+ */
+static bool bandDirty(uint8_t row, uint8_t col) {
+  return g_dirty[row][col >> 3] & (1 << (col & 0x07));
+  }
+
+/** Update the pixels in a single byte of the band
+ *
+ * The column is only marked as changed if the value is actually modified.
+ *
+ * @param row the row within the band.
+ * @param col the column to update.
+ * @param mask the bits to change.
+ * @param on if true the bits are set, otherwise they are cleared.
+ */
+static void bandUpdate(uint8_t row, uint8_t col, uint8_t mask, bool on) {
+  uint8_t old = g_band[row][col];
+  uint8_t val = on?(old | mask):(old & ~mask);
+  if(val==old)
+    return;
+  g_band[row][col] = val;
+  g_dirty[row][col >> 3] |= (1 << (col & 0x07));
+  }
+
+/** Set or clear a vertical run of pixels in a single column
+ *
+ * @param col the column to update.
+ * @param top the vertical position of the first pixel.
+ * @param bottom the vertical position of the last pixel (inclusive).
+ * @param on if true the pixels are set, otherwise they are cleared.
+ */
+static void bandColumn(uint8_t col, uint8_t top, uint8_t bottom, bool on) {
+  if((col>=LCD_COL)||(g_bandRow>=LCD_ROW))
+    return;
+  for(uint8_t row=0; row<LCD_BAND_ROWS; row++) {
+    uint8_t first = (g_bandRow + row) * 8;
+    uint8_t last = first + 7;
+    if((bottom<first)||(top>last))
+      continue;
+    uint8_t lo = (top>first)?(top - first):0;
+    uint8_t hi = (bottom<last)?(bottom - first):7;
+    bandUpdate(row, col, (0xFF << lo) & (0xFF >> (7 - hi)), on);
+    }
+  }
+
+/** Select the rows covered by the frame buffer band
+ *
+ * Sets the top row of the band and resets the band to the background color.
+ * The band assumes the display already shows the background color in these
+ * rows (after lcdClear() or lcdClearRow() for example) so nothing is marked
+ * as changed. Selecting the row and background that are already active
+ * does nothing, this lets a program keep redrawing the same band and only
+ * send the changes. Selecting a different row or background throws away
+ * any changes in the band that have not been sent with lcdFlush().
+ *
+ * @param row the row number (0 to 5) for the top of the band. The band is
+ *            moved up if it would extend past the bottom of the display.
+ * @param invert if true the background is black rather than white.
+ */
+void lcdBandSelect(uint8_t row, bool invert) {
+  if(row>(LCD_ROW - LCD_BAND_ROWS))
+    row = LCD_ROW - LCD_BAND_ROWS;
+  if((row==g_bandRow)&&(invert==g_bandInvert))
+    return;
+  g_bandRow = row;
+  g_bandInvert = invert;
+  uint8_t fill = invert?0xFF:0x00;
+  for(row=0; row<LCD_BAND_ROWS; row++) {
+    for(uint8_t col=0; col<LCD_COL; col++)
+      g_band[row][col] = fill;
+    for(uint8_t index=0; index<DIRTY_BYTES; index++)
+      g_dirty[row][index] = 0;
+    }
+  }
+
+/** Set or clear a single pixel in the band
+ *
+ * @param x the horizontal pixel position (0 to 83).
+ * @param y the vertical pixel position (0 to 47).
+ * @param on if true the pixel is set (black), otherwise it is cleared.
+ */
+void lcdPixel(uint8_t x, uint8_t y, bool on) {
+  bandColumn(x, y, y, on);
+  }
+
+/** Draw a line in the band
+ *
+ * Draws a line between the two end points (inclusive).
+ *
+ * @param x0 the horizontal position of the start point.
+ * @param y0 the vertical position of the start point.
+ * @param x1 the horizontal position of the end point.
+ * @param y1 the vertical position of the end point.
+ * @param on if true the pixels are set (black), otherwise they are cleared.
+ */
+void lcdLine(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool on) {
+  // Vertical lines can be done a byte at a time
+  if(x0==x1) {
+    if(y0>y1)
+      bandColumn(x0, y1, y0, on);
+    else
+      bandColumn(x0, y0, y1, on);
+    return;
+    }
+  // Use Bresenham for everything else
+  int16_t dx = (x1>x0)?(x1 - x0):(x0 - x1);
+  int16_t dy = (y1>y0)?(y0 - y1):(y1 - y0);
+  int8_t sx = (x1>x0)?1:-1;
+  int8_t sy = (y1>y0)?1:-1;
+  int16_t err = dx + dy;
+  while(true) {
+    bandColumn(x0, y0, y0, on);
+    if((x0==x1)&&(y0==y1))
+      return;
+    int16_t e2 = err * 2;
+    if(e2>=dy) {
+      err += dy;
+      x0 += sx;
+      }
+    if(e2<=dx) {
+      err += dx;
+      y0 += sy;
+      }
+    }
+  }
+
+/** Draw a rectangle in the band
+ *
+ * @param x the horizontal position of the top left corner.
+ * @param y the vertical position of the top left corner.
+ * @param w the width of the rectangle in pixels.
+ * @param h the height of the rectangle in pixels.
+ * @param on if true the pixels are set (black), otherwise they are cleared.
+ * @param fill if true the rectangle is filled, otherwise only the outline
+ *             is drawn.
+ */
+void lcdRect(uint8_t x, uint8_t y, uint8_t w, uint8_t h, bool on, bool fill) {
+  if((w==0)||(h==0))
+    return;
+  uint8_t right = ((x + w)>LCD_COL)?(LCD_COL - 1):(x + w - 1);
+  uint8_t bottom = ((y + h)>(LCD_ROW * 8))?((LCD_ROW * 8) - 1):(y + h - 1);
+  for(uint8_t col=x; col<=right; col++) {
+    if(fill||(col==x)||(col==(x + w - 1)))
+      bandColumn(col, y, bottom, on);
+    else {
+      bandColumn(col, y, y, on);
+      if(bottom==(y + h - 1))
+        bandColumn(col, bottom, bottom, on);
+      }
+    }
+  }
+
+/** Send the changes in the band to the display
+ *
+ * Transmits the columns that have changed since the last flush. Adjacent
+ * changed columns are sent as a single span and small gaps between spans are
+ * bridged when that is cheaper than setting a new address.
+ */
+void lcdFlush() {
+  for(uint8_t row=0; row<LCD_BAND_ROWS; row++) {
+    uint8_t col = 0;
+    while(col<LCD_COL) {
+      if(!bandDirty(row, col)) {
+        col++;
+        continue;
+        }
+      // Find the end of the span
+      uint8_t last = col;
+      for(uint8_t end=col + 1; (end<LCD_COL)&&((end - last)<=(SPAN_GAP + 1)); end++) {
+        if(bandDirty(row, end))
+          last = end;
+        }
+      // Set the address and send it
+      lcdCommand(0x80 | col);
+      lcdCommand(0x40 | (g_bandRow + row));
+      for(; col<=last; col++)
+        lcdData(g_band[row][col]);
+      }
+    // Everything is now up to date
+    for(uint8_t index=0; index<DIRTY_BYTES; index++)
+      g_dirty[row][index] = 0;
+    }
+  }
+
+// Only provide the functions if the driver and band are enabled
+#endif /* LCD_ENABLED && LCD_BAND_ENABLED */
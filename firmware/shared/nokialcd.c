@@ -12,6 +12,7 @@
 #include "iohelp.h"
 #include "smallfont.h"
 #include "nokialcd.h"
+#include "rle.h"
 
 // Only provide the functions if the driver is enabled
 #ifdef LCD_ENABLED
@@ -49,8 +50,8 @@ void lcdInit() {
   uint8_t val = (1 << LCD_SCK) | (1 << LCD_MOSI) | (1 << LCD_RESET) | (1 << LCD_CD);
   PORTB &= ~val;
   DDRB |= val;
-  // Do a hard reset on the LCD
-  wait(10);
+  // Do a hard reset on the LCD (the pulse only needs to be 100ns)
+  delayUs(1);
   PORTB |= (1 << LCD_RESET);
   // Initialise the LCD
   lcdCommand(0x21);  // LCD Extended Commands.
@@ -226,6 +227,45 @@ void lcdImageP(uint8_t row, uint8_t col, const uint8_t *img, bool invert) {
     }
   }
 
+/** Display a run length compressed graphic on the display
+ *
+ * This function displays graphics generated by 'tools/lcdimage.py --rle'.
+ * The first two bytes of the graphic are the height (in 8 pixel rows) and
+ * the width (in pixel columns), allowing images up to the full size of the
+ * display. The remaining data is the same sequence of 8 pixel vertical strips
+ * used by lcdImageP() compressed as a series of packets. Each packet starts
+ * with a control byte - values from 0x00 to 0x7F are followed by (value + 1)
+ * literal bytes, values from 0x80 to 0xFF are followed by a single byte that
+ * is repeated ((value & 0x7F) + 3) times.
+ *
+ * The data is decoded directly to the display (see rle.h) so no RAM buffer
+ * is required. Images that will display off the edge of the screen are
+ * clipped, images with a width or height of zero are ignored.
+ *
+ * @param row the row number (0 to 5) to start the top left of the image.
+ * @param col the column number (0 to 83) to start the top left of the image.
+ * @param img pointer to the compressed image in PROGMEM.
+ * @param invert if true the pixel colors will be inverted.
+ */
+void lcdImageRleP(uint8_t row, uint8_t col, const uint8_t *img, bool invert) {
+  RLE_STATE rle;
+  uint8_t height, width;
+  if(!rleStartP(&rle, img, &height, &width))
+    return;
+  uint8_t mask = invert?0xFF:0x00;
+  for(; (height>0)&&(row<LCD_ROW); height--, row++) {
+    // Set the starting address for this row
+    lcdCommand(0x80 | col);
+    lcdCommand(0x40 | row);
+    // Send the data (up to the end of the screen)
+    for(uint8_t offset=0; offset<width; offset++) {
+      uint8_t data = rleNextP(&rle);
+      if((col+offset)<LCD_COL)
+        lcdData(data ^ mask);
+      }
+    }
+  }
+
 // Only provide the functions if the driver is enabled
 #endif /* LCD_ENABLED */
 
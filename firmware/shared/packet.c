@@ -0,0 +1,225 @@
+/*--------------------------------------------------------------------------*
+* Packet protocol implementation
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* COBS encodes the data as a series of blocks. Each block starts with a code
+* byte giving the offset to the next zero in the data (which is not sent).
+* A code of 0xFF means 254 data bytes with no zero following them.
+*
+* The receiver holds back the last two decoded bytes so they are not added
+* to the CRC - they turn out to be the CRC itself when the delimiter arrives.
+*
+* The CRC is calculated bit by bit rather than with crcByte() - the lookup
+* table that uses is shared with the bootloader and does not match the
+* CCITT polynomial for half of its entries, so some single byte errors are
+* not detected.
+*--------------------------------------------------------------------------*/
+#include <avr/io.h>
+#include "../hardware.h"
+#include "softuart.h"
+#include "packet.h"
+
+// Only if enabled
+#if defined(PACKET_ENABLED) && defined(UART_ENABLED)
+
+// Sanity checks
+#if PACKET_SIZE > 253
+#  error "PACKET_SIZE must be 253 bytes or less"
+#endif
+
+// Longest run of data bytes in a block
+#define COBS_RUN 254
+
+// CRC-16/CCITT polynomial and initial value
+#define CRC_POLY 0x1021
+#define CRC_INIT 0xFFFF
+
+//! The payload of the packet being received
+static uint8_t g_packet[PACKET_SIZE];
+static uint8_t g_length;
+
+//! Length of the last complete packet
+static uint8_t g_ready = 0;
+
+//! The last two bytes decoded (not added to the CRC yet)
+static uint16_t g_hold;
+static uint8_t g_held;
+
+//! CRC of the payload so far
+static uint16_t g_crc;
+
+//! Code for the current block (0 between packets) and bytes left in it
+static uint8_t g_code = 0;
+static uint8_t g_remaining;
+
+//! Set if the payload did not fit in the buffer
+static bool g_overflow;
+
+//! Number of errors seen
+static uint8_t g_errors = 0;
+
+/** Add a byte to the packet CRC
+ *
+ * @param crc the current CRC value.
+ * @param data the data byte to add.
+ *
+ * @return the updated CRC value.
+ */
+static uint16_t packetCrc(uint16_t crc, uint8_t data) {
+  crc ^= (uint16_t)data << 8;
+  for(uint8_t bit=0; bit<8; bit++)
+    crc = (crc & 0x8000)?((crc << 1) ^ CRC_POLY):(crc << 1);
+  return crc;
+  }
+
+/** Get a byte from the data to be sent (the payload followed by the CRC)
+ */
+static uint8_t packetByte(const uint8_t *pData, uint8_t length, uint16_t crc, uint8_t index) {
+  if(index<length)
+    return pData[index];
+  return (index==length)?(crc >> 8):(crc & 0xFF);
+  }
+
+/** Add a decoded byte to the packet
+ *
+ * The byte is held back until two more have been decoded.
+ */
+static void packetAdd(uint8_t data) {
+  if(g_held==2) {
+    uint8_t ch = g_hold >> 8;
+    g_crc = packetCrc(g_crc, ch);
+    if(g_length<PACKET_SIZE)
+      g_packet[g_length++] = ch;
+    else
+      g_overflow = true;
+    }
+  else
+    g_held++;
+  g_hold = (g_hold << 8) | data;
+  }
+
+/** Send a packet
+ *
+ * The payload is encoded and sent as it is read so no extra buffer space is
+ * needed.
+ *
+ * @param pData pointer to the payload.
+ * @param length the number of bytes in the payload (max 253).
+ */
+void packetSend(const uint8_t *pData, uint8_t length) {
+  uint16_t crc = CRC_INIT;
+  uint8_t total = length + 2, pos = 0, run, index;
+  for(index=0; index<length; index++)
+    crc = packetCrc(crc, pData[index]);
+  while(true) {
+    // Find the next zero (or the longest block)
+    for(run=0; ((pos + run)<total)&&(run<COBS_RUN)&&(packetByte(pData, length, crc, pos + run)!=0); run++);
+    uartSend(run + 1);
+    for(index=0; index<run; index++)
+      uartSend(packetByte(pData, length, crc, pos + index));
+    pos += run;
+    if(pos>=total)
+      break;
+    // Skip the zero (it is implied by the code)
+    if(run<COBS_RUN)
+      pos++;
+    }
+  uartSend(PACKET_END);
+  }
+
+/** Process a single received byte
+ *
+ * The byte is decoded and added to the CRC as it arrives so completing a
+ * packet only needs a comparison. Use this to feed data from a source other
+ * than the UART, otherwise use packetPoll().
+ *
+ * @param ch the byte received.
+ *
+ * @return true if the byte completed a valid packet. The packet is
+ *         available from packetData() until the next byte is processed.
+ */
+bool packetFeed(uint8_t ch) {
+  if(ch==PACKET_END) {
+    bool valid = false;
+    // Ignore empty frames (repeated delimiters)
+    if(g_code!=0) {
+      if((g_remaining==0)&&(g_held==2)&&!g_overflow&&(g_hold==g_crc)) {
+        g_ready = g_length;
+        valid = true;
+        }
+      else if(g_errors<255)
+        g_errors++;
+      }
+    g_code = 0;
+    return valid;
+    }
+  if(g_code==0) {
+    // Start of a new packet
+    g_length = 0;
+    g_held = 0;
+    g_crc = CRC_INIT;
+    g_overflow = false;
+    }
+  else if(g_remaining>0) {
+    // Data byte in the current block
+    packetAdd(ch);
+    g_remaining--;
+    return false;
+    }
+  else if(g_code!=(COBS_RUN + 1)) {
+    // The previous block was followed by a zero
+    packetAdd(0);
+    }
+  // Start a new block
+  g_code = ch;
+  g_remaining = ch - 1;
+  return false;
+  }
+
+/** Check for a complete packet
+ *
+ * Processes any data waiting in the UART buffer without blocking. Call this
+ * often enough to stop the UART buffer overflowing (UART_BUFFER characters
+ * take about 0.7ms to arrive at 57600 baud). Requires the interrupt driven
+ * UART.
+ *
+ * @return true if a valid packet has been received. The packet is available
+ *         from packetData() until the next call.
+ */
+bool packetPoll() {
+  while(uartAvail()) {
+    if(packetFeed(uartRecv()))
+      return true;
+    }
+  return false;
+  }
+
+/** Get the payload of the last packet received
+ *
+ * @return pointer to the payload.
+ */
+const uint8_t *packetData() {
+  return g_packet;
+  }
+
+/** Get the length of the last packet received
+ *
+ * @return the number of bytes in the payload.
+ */
+uint8_t packetLength() {
+  return g_ready;
+  }
+
+/** Get the number of receive errors
+ *
+ * Counts packets discarded because the CRC did not match, they were too
+ * large for the buffer or the framing was broken. The count stops at 255.
+ *
+ * @return the number of errors since startup.
+ */
+uint8_t packetErrors() {
+  return g_errors;
+  }
+
+#endif /* PACKET_ENABLED && UART_ENABLED */
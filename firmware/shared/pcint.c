@@ -0,0 +1,113 @@
+/*--------------------------------------------------------------------------*
+* Pin change interrupt dispatcher implementation
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Takes ownership of PCINT0_vect. If the UART is interrupt driven it is
+* given the first chance to run (the start bit timing depends on it),
+* followed by each additional UART channel in UART_CHANNELS (softuart.h)
+* and then the handler for each monitored pin that has changed is called.
+*--------------------------------------------------------------------------*/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "../hardware.h"
+#include "uart_defs.h"
+#include "softuart.h"
+#include "latency.h"
+#include "pcint.h"
+
+// Only if enabled
+#ifdef PCINT_ENABLED
+
+// Number of pins that can generate a pin change interrupt
+#define PCINT_PINS 6
+
+//! Handlers for each pin
+static PCINT_HANDLER g_handlers[PCINT_PINS];
+
+//! Pins with a handler attached
+static volatile uint8_t g_mask = 0;
+
+//! Last known state of the monitored pins
+static volatile uint8_t g_pins = 0;
+
+#if defined(UART_ENABLED) && defined(UART_INTERRUPT)
+// UART receive handler (in uart_recv.c)
+void uartPinChange();
+
+// Pins reserved for the UART
+#  define PCINT_RESERVED (1 << UART_RX)
+#else
+#  define PCINT_RESERVED 0
+#endif
+
+// Pins reserved for the additional UART channels (see softuart.h)
+#define PCINT_CHANNEL_PIN(name, rx) | (1 << (rx))
+#define PCINT_RESERVED1 (0 UART_CHANNELS(PCINT_CHANNEL_PIN))
+
+// Call the receive handler for a channel
+#define PCINT_CHANNEL_CALL(name, rx) name##PinChange();
+
+/** Attach a handler to a pin
+ *
+ * Enables the pin change interrupt for the pin and calls the handler on
+ * every edge. The UART receive pins cannot be used when the UARTs are
+ * interrupt driven, they are always serviced first by the dispatcher.
+ *
+ * @param pin the pin to monitor (PINB0 to PINB5).
+ * @param handler the function to call when the pin changes.
+ *
+ * @return true if the handler was attached.
+ */
+bool pcintAttach(uint8_t pin, PCINT_HANDLER handler) {
+  if((pin>=PCINT_PINS)||(handler==0)||((PCINT_RESERVED | PCINT_RESERVED1) & (1 << pin)))
+    return false;
+  LATENCY_SAVE(sreg);
+  g_handlers[pin] = handler;
+  // Take the current state so we only see changes from now on
+  g_pins = (g_pins & ~(1 << pin)) | (PINB & (1 << pin));
+  g_mask |= (1 << pin);
+  PCMSK |= (1 << pin);
+  GIMSK |= (1 << PCIE);
+  LATENCY_RESTORE(sreg);
+  return true;
+  }
+
+/** Remove the handler for a pin
+ *
+ * Disables the pin change interrupt for the pin (unless a UART is using
+ * it).
+ *
+ * @param pin the pin to stop monitoring.
+ */
+void pcintDetach(uint8_t pin) {
+  if((pin>=PCINT_PINS)||((PCINT_RESERVED | PCINT_RESERVED1) & (1 << pin)))
+    return;
+  LATENCY_SAVE(sreg);
+  g_mask &= ~(1 << pin);
+  PCMSK &= ~(1 << pin);
+  if(PCMSK==0)
+    GIMSK &= ~(1 << PCIE);
+  LATENCY_RESTORE(sreg);
+  }
+
+/** Pin change interrupt handler
+ */
+ISR(PCINT0_vect) {
+  LATENCY_ISR();
+#if defined(UART_ENABLED) && defined(UART_INTERRUPT)
+  // The UART is time critical so it goes first
+  uartPinChange();
+#endif
+  // Then the additional channels in order
+  UART_CHANNELS(PCINT_CHANNEL_CALL)
+  uint8_t pins = PINB;
+  uint8_t changed = (pins ^ g_pins) & g_mask;
+  g_pins = pins;
+  for(uint8_t pin=0; changed; pin++, changed >>= 1) {
+    if(changed & 0x01)
+      g_handlers[pin](pin, pins & (1 << pin));
+    }
+  }
+
+#endif /* PCINT_ENABLED */
@@ -0,0 +1,120 @@
+/*--------------------------------------------------------------------------*
+* Cycle profiler implementation
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Accumulates timing information for regions of code marked with the
+* PROFILE_BEGIN() and PROFILE_END() macros.
+*--------------------------------------------------------------------------*/
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "../hardware.h"
+#include "softuart.h"
+#include "systicks.h"
+#include "profile.h"
+
+// Only if enabled
+#ifdef PROFILE
+
+/** Timing information for a single region
+ */
+typedef struct _PROFILE_REGION {
+  uint16_t start; //!< Time stamp at the start of the current measurement
+  uint16_t count; //!< Number of measurements taken
+  uint16_t min;   //!< Shortest measurement (in time stamp counts)
+  uint16_t max;   //!< Longest measurement (in time stamp counts)
+  uint32_t total; //!< Sum of all measurements (in time stamp counts)
+  } PROFILE_REGION;
+
+//! Results for each region
+static PROFILE_REGION g_regions[PROFILE_REGIONS];
+
+/** Print a value in cycles
+ *
+ * Values can exceed the 16 bit range of uartInt() once converted.
+ *
+ * @param counts the value to print in time stamp counts.
+ */
+static void printCycles(uint32_t counts) {
+  char digits[10];
+  uint8_t index = 0;
+  counts = counts * TICKS_FINE_CYCLES;
+  do {
+    digits[index++] = '0' + (counts % 10);
+    counts = counts / 10;
+    }
+  while(counts>0);
+  uartSend(' ');
+  while(index>0)
+    uartSend(digits[--index]);
+  }
+
+/** Start timing a region
+ *
+ * Records the current time stamp (see ticksFine()) for the region. Use the
+ * PROFILE_BEGIN() macro rather than calling this directly so the call is
+ * removed when profiling is not enabled.
+ *
+ * @param id the region identifier (0 to PROFILE_REGIONS - 1).
+ */
+void profileBegin(uint8_t id) {
+  if(id<PROFILE_REGIONS)
+    g_regions[id].start = ticksFine();
+  }
+
+/** Finish timing a region
+ *
+ * Updates the count, total, minimum and maximum time for the region. Use
+ * the PROFILE_END() macro rather than calling this directly so the call is
+ * removed when profiling is not enabled.
+ *
+ * @param id the region identifier (0 to PROFILE_REGIONS - 1).
+ */
+void profileEnd(uint8_t id) {
+  uint16_t now = ticksFine();
+  if(id>=PROFILE_REGIONS)
+    return;
+  PROFILE_REGION *region = &g_regions[id];
+  uint16_t elapsed = now - region->start;
+  // Stop counting rather than wrap around
+  if(region->count==0xFFFF)
+    return;
+  if((region->count==0)||(elapsed<region->min))
+    region->min = elapsed;
+  if(elapsed>region->max)
+    region->max = elapsed;
+  region->total += elapsed;
+  region->count++;
+  }
+
+/** Clear all profiling results
+ */
+void profileReset() {
+  for(uint8_t id=0; id<PROFILE_REGIONS; id++) {
+    g_regions[id].count = 0;
+    g_regions[id].max = 0;
+    g_regions[id].total = 0;
+    }
+  }
+
+/** Print the profiling results to the UART
+ *
+ * Prints a line for each region that has been used showing the region id,
+ * the number of times it was timed and the minimum, maximum and average time
+ * taken in CPU cycles.
+ */
+void profileDump() {
+  uartPrintP(PSTR("PROFILE: id count min max avg\n"));
+  for(uint8_t id=0; id<PROFILE_REGIONS; id++) {
+    PROFILE_REGION *region = &g_regions[id];
+    if(region->count==0)
+      continue;
+    uartFormatP(PSTR("PROFILE: %u %u"), id, region->count);
+    printCycles(region->min);
+    printCycles(region->max);
+    printCycles(region->total / region->count);
+    uartSend('\n');
+    }
+  }
+
+#endif /* PROFILE */
@@ -0,0 +1,65 @@
+/*--------------------------------------------------------------------------*
+* Run length compressed image decoder
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Decodes images generated by 'tools/lcdimage.py --rle' one byte at a time
+* so the display drivers can send the data as it is expanded without a RAM
+* buffer.
+*--------------------------------------------------------------------------*/
+#include <avr/pgmspace.h>
+#include "rle.h"
+
+/** Start decoding a compressed image
+ *
+ * Reads the image header. The first two bytes of the image are the height
+ * (in 8 pixel rows) and the width (in pixel columns). The remaining data is
+ * a series of packets, each starting with a control byte - values from 0x00
+ * to 0x7F are followed by (value + 1) literal bytes, values from 0x80 to
+ * 0xFF are followed by a single byte that is repeated ((value & 0x7F) + 3)
+ * times.
+ *
+ * @param pState the decoder state to initialise.
+ * @param img pointer to the compressed image in PROGMEM.
+ * @param pHeight receives the height of the image (in 8 pixel rows).
+ * @param pWidth receives the width of the image (in pixel columns).
+ *
+ * @return true if the image can be displayed, false if the width or height
+ *         is zero.
+ */
+bool rleStartP(RLE_STATE *pState, const uint8_t *img, uint8_t *pHeight, uint8_t *pWidth) {
+  *pHeight = pgm_read_byte_near(img++);
+  *pWidth = pgm_read_byte_near(img++);
+  pState->img = img;
+  pState->count = 0;
+  pState->run = false;
+  return (*pHeight!=0)&&(*pWidth!=0);
+  }
+
+/** Get the next byte of image data
+ *
+ * Bytes are returned in display order (the vertical strips of the first
+ * row from left to right, then the next row). The caller must not read more
+ * than height * width bytes.
+ *
+ * @param pState the decoder state.
+ *
+ * @return the next 8 pixel vertical strip.
+ */
+uint8_t rleNextP(RLE_STATE *pState) {
+  // Start a new packet if needed
+  if(pState->count==0) {
+    uint8_t ctrl = pgm_read_byte_near(pState->img++);
+    pState->run = ctrl & 0x80;
+    if(pState->run) {
+      pState->count = (ctrl & 0x7F) + 3;
+      pState->data = pgm_read_byte_near(pState->img++);
+      }
+    else
+      pState->count = ctrl + 1;
+    }
+  pState->count--;
+  if(pState->run)
+    return pState->data;
+  return pgm_read_byte_near(pState->img++);
+  }
@@ -0,0 +1,373 @@
+/*--------------------------------------------------------------------------*
+* SSD1306 OLED Interface
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Simple routines for controlling a 128 x 64 SSD1306 OLED over I2C.
+*
+* The display is driven with horizontal addressing and a column/page window
+* so each drawing operation is a single I2C transaction - the address and
+* control byte are only sent once per operation rather than once per byte.
+*--------------------------------------------------------------------------*/
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "../hardware.h"
+#include "utility.h"
+#include "smallfont.h"
+#include "ssd1306.h"
+#include "rle.h"
+
+// Only provide the functions if the driver is enabled
+#ifdef OLED_ENABLED
+
+// Control bytes sent after the address
+#define OLED_CMD_STREAM  0x00
+#define OLED_DATA_STREAM 0x40
+
+//---------------------------------------------------------------------------
+// Software I2C (write only)
+//
+// Lines are driven open drain by leaving the output value low and switching
+// the pin between input (released, pulled high) and output (driven low).
+// The delays give the fast mode (400KHz) minimum low and high times and
+// every rising clock edge waits until SCL reads high so slow pull ups and
+// clock stretching are allowed for. With the loop overhead the bus runs at
+// around 300KHz at 8MHz.
+//---------------------------------------------------------------------------
+
+#define SDA_HIGH() DDRB &= ~(1 << OLED_SDA)
+#define SDA_LOW()  DDRB |= (1 << OLED_SDA)
+#define SCL_LOW()  DDRB |= (1 << OLED_SCL)
+
+// Fast mode bus timing (SCL low also covers the SDA setup time)
+#define I2C_DELAY_LOW()  delayUs(1.3)
+#define I2C_DELAY_HIGH() delayUs(0.6)
+
+/** Release SCL and wait for it to go high
+ *
+ * The display may hold SCL low to stretch the clock and the line takes
+ * time to rise through the pull up resistor.
+ */
+static void i2cClockHigh() {
+  DDRB &= ~(1 << OLED_SCL);
+  while(!(PINB & (1 << OLED_SCL)));
+  I2C_DELAY_HIGH();
+  }
+
+/** Write a single byte to the bus
+ *
+ * The acknowledge bit from the display is clocked but ignored. SCL must be
+ * low on entry and is left low.
+ *
+ * @param data the byte to send.
+ */
+static void i2cWrite(uint8_t data) {
+  for(uint8_t mask=0x80; mask; mask = mask >> 1) {
+    if(data&mask)
+      SDA_HIGH();
+    else
+      SDA_LOW();
+    I2C_DELAY_LOW();
+    i2cClockHigh();
+    SCL_LOW();
+    }
+  // Clock the acknowledge bit
+  SDA_HIGH();
+  I2C_DELAY_LOW();
+  i2cClockHigh();
+  SCL_LOW();
+  }
+
+/** Start a transaction with the display
+ *
+ * @param control the control byte indicating a command or data stream.
+ */
+static void oledBegin(uint8_t control) {
+  // Start condition (the bus is idle with both lines high)
+  SDA_LOW();
+  I2C_DELAY_HIGH();
+  SCL_LOW();
+  // Address and control byte
+  i2cWrite(OLED_ADDRESS << 1);
+  i2cWrite(control);
+  }
+
+/** End the current transaction
+ */
+static void oledEnd() {
+  SDA_LOW();
+  I2C_DELAY_LOW();
+  i2cClockHigh();
+  SDA_HIGH();
+  // Bus free time before the next start
+  I2C_DELAY_LOW();
+  }
+
+/** Set the drawing window and start a data transaction
+ *
+ * @param col the first column of the window.
+ * @param width the number of columns in the window.
+ * @param row the first page of the window.
+ * @param height the number of pages in the window.
+ */
+static void oledWindow(uint8_t col, uint8_t width, uint8_t row, uint8_t height) {
+  oledBegin(OLED_CMD_STREAM);
+  i2cWrite(0x21); // Column range
+  i2cWrite(col);
+  i2cWrite(((col + width)>OLED_COL)?(OLED_COL - 1):(col + width - 1));
+  i2cWrite(0x22); // Page range
+  i2cWrite(row);
+  i2cWrite(((row + height)>OLED_ROW)?(OLED_ROW - 1):(row + height - 1));
+  oledEnd();
+  oledBegin(OLED_DATA_STREAM);
+  }
+
+/** Send the glyph for a single character
+ *
+ * Must be called inside a data transaction. Columns past the edge of the
+ * display are not sent.
+ *
+ * @param col the current column, updated as bytes are sent.
+ * @param ch the character to send.
+ * @param mask value to XOR with the glyph data.
+ */
+static void oledGlyph(uint8_t *col, char ch, uint8_t mask) {
+  // If the character is invalid replace it with the '?'
+  if((ch<0x20)||(ch>0x7f))
+    ch = '?';
+  const uint8_t *chdata = SMALL_FONT + ((ch - 0x20) * DATA_WIDTH);
+  for(uint8_t pixels = 0; (pixels < DATA_WIDTH) && (*col < OLED_COL); pixels++, (*col)++, chdata++)
+    i2cWrite(pgm_read_byte_near(chdata) ^ mask);
+  // Add the padding byte
+  if(*col < OLED_COL) {
+    i2cWrite(mask);
+    (*col)++;
+    }
+  }
+
+//---------------------------------------------------------------------------
+// Public API
+//---------------------------------------------------------------------------
+
+/** Initialisation sequence
+ */
+static const uint8_t OLED_INIT[] PROGMEM = {
+  0xAE,       // Display off
+  0xD5, 0x80, // Clock divider
+  0xA8, 0x3F, // Multiplex ratio (64 lines)
+  0xD3, 0x00, // No display offset
+  0x40,       // Start line 0
+  0x8D, 0x14, // Enable charge pump
+  0x20, 0x00, // Horizontal addressing
+  0xA1,       // Segment remap
+  0xC8,       // Scan from COM63 to COM0
+  0xDA, 0x12, // COM pin configuration
+  0x81, 0xCF, // Contrast
+  0xD9, 0xF1, // Pre-charge period
+  0xDB, 0x40, // VCOMH deselect level
+  0xA4,       // Display follows RAM
+  0xA6,       // Normal (not inverted) display
+  0xAF,       // Display on
+  };
+
+/** Initialise the OLED
+ *
+ * Sets up the pins required to communicate with the display and then does
+ * the actual chipset initialisation. The pin numbers and I2C address to use
+ * are defined in @ref hardware.h.
+ */
+void oledInit() {
+  // Both lines are released (inputs) with the output value low
+  uint8_t val = (1 << OLED_SDA) | (1 << OLED_SCL);
+  PORTB &= ~val;
+  DDRB &= ~val;
+  // Send the initialisation sequence in a single transaction
+  oledBegin(OLED_CMD_STREAM);
+  for(uint8_t index=0; index<sizeof(OLED_INIT); index++)
+    i2cWrite(pgm_read_byte_near(OLED_INIT + index));
+  oledEnd();
+  }
+
+/** Send a command byte to the OLED
+ *
+ * Each call is a separate I2C transaction. The drawing functions below batch
+ * their commands and data so prefer those where possible.
+ *
+ * @param cmd the command byte to send.
+ */
+void oledCommand(uint8_t cmd) {
+  oledBegin(OLED_CMD_STREAM);
+  i2cWrite(cmd);
+  oledEnd();
+  }
+
+/** Clear the screen
+ *
+ * Clear the entire display.
+ *
+ * @param invert if true the colors are inverted and the screen will be filled
+ *               with white.
+ */
+void oledClear(bool invert) {
+  uint8_t fill = invert?0xFF:0x00;
+  oledWindow(0, OLED_COL, 0, OLED_ROW);
+  for(uint16_t index = 0; index < (OLED_COL * OLED_ROW); index++)
+    i2cWrite(fill);
+  oledEnd();
+  }
+
+/** Clear a single row
+ *
+ * Clears a single character row from the left edge of the screen to the right.
+ *
+ * @param row the row number (0 to 7) to clear.
+ * @param invert if true the colors are inverted and the row will be filled
+ *               with white.
+ */
+void oledClearRow(uint8_t row, bool invert) {
+  uint8_t fill = invert?0xFF:0x00;
+  oledWindow(0, OLED_COL, row % OLED_ROW, 1);
+  for(uint8_t index = 0; index < OLED_COL; index++)
+    i2cWrite(fill);
+  oledEnd();
+  }
+
+/** Write a single character
+ *
+ * Display a single ASCII character at the position described by the row and
+ * column parameters. Note that the row indicates an 8 pixel high character
+ * row while the column represents individual pixels. Each character is 5
+ * pixels wide with a single column of spacing giving a total of 6 pixels.
+ *
+ * @param row the row number (0 to 7) to display the character.
+ * @param col the column position (0 to 127) for the start of the left side of
+ *            the character.
+ * @param ch  the character to display. If the character is out of range it
+ *            will be replaced with the '?' character.
+ * @param invert if true the colors are inverted and the character will be
+ *               displayed as black on white.
+ */
+void oledPrintChar(uint8_t row, uint8_t col, char ch, bool invert) {
+  // Make sure it is on the screen
+  if((row>=OLED_ROW)||(col>=OLED_COL))
+    return;
+  oledWindow(col, CHAR_WIDTH, row, 1);
+  oledGlyph(&col, ch, invert?0xFF:0x00);
+  oledEnd();
+  }
+
+/** Write a nul terminated string
+ *
+ * Display a string of ASCII characters at the position described by the row
+ * and column parameters. The string is sent in a single I2C transaction and
+ * will be clipped at the right edge of the display.
+ *
+ * @param row the row number (0 to 7) to display the string.
+ * @param col the column position (0 to 127) for the start of the left side of
+ *            the string.
+ * @param str the string to display. If a character in the string is out of
+ *            range it will be replaced with the '?' character.
+ * @param invert if true the colors are inverted and the characters will be
+ *               displayed as black on white.
+ */
+void oledPrint(uint8_t row, uint8_t col, const char *str, bool invert) {
+  if((row>=OLED_ROW)||(col>=OLED_COL))
+    return;
+  oledWindow(col, OLED_COL - col, row, 1);
+  for(;(*str!='\0')&&(col<OLED_COL);str++)
+    oledGlyph(&col, *str, invert?0xFF:0x00);
+  oledEnd();
+  }
+
+/** Write a nul terminated string from PROGMEM
+ *
+ * Display a string of ASCII characters at the position described by the row
+ * and column parameters. The string is sent in a single I2C transaction and
+ * will be clipped at the right edge of the display.
+ *
+ * @param row the row number (0 to 7) to display the string.
+ * @param col the column position (0 to 127) for the start of the left side of
+ *            the string.
+ * @param str the string to display. If a character in the string is out of
+ *            range it will be replaced with the '?' character.
+ * @param invert if true the colors are inverted and the characters will be
+ *               displayed as black on white.
+ */
+void oledPrintP(uint8_t row, uint8_t col, const char *str, bool invert) {
+  if((row>=OLED_ROW)||(col>=OLED_COL))
+    return;
+  oledWindow(col, OLED_COL - col, row, 1);
+  while(col<OLED_COL) {
+    char ch = pgm_read_byte_near(str);
+    if(ch=='\0')
+      break;
+    oledGlyph(&col, ch, invert?0xFF:0x00);
+    str++;
+    }
+  oledEnd();
+  }
+
+/** Display an arbitrary graphic on the display
+ *
+ * Displays an image in the same format used by lcdImageP(). The whole image
+ * is sent in a single I2C transaction. Images that will display off the edge
+ * of the screen are clipped.
+ *
+ * @param row the row number (0 to 7) to start the top left of the image.
+ * @param col the column number (0 to 127) to start the top left of the image.
+ * @param img pointer to the image in PROGMEM.
+ * @param invert if true the pixel colors will be inverted.
+ */
+void oledImageP(uint8_t row, uint8_t col, const uint8_t *img, bool invert) {
+  if((row>=OLED_ROW)||(col>=OLED_COL))
+    return;
+  // Break out the width and height
+  uint8_t data = pgm_read_byte_near(img++);
+  uint8_t height = (data >> 6) + 1;
+  uint8_t width = (data & 0x03F) + 1;
+  uint8_t mask = invert?0xFF:0x00;
+  oledWindow(col, width, row, height);
+  for(; (height>0)&&(row<OLED_ROW); height--, row++) {
+    // Send the data (up to the end of the screen)
+    for(uint8_t offset=0; offset<width; offset++, img++) {
+      if((col+offset)<OLED_COL)
+        i2cWrite(pgm_read_byte_near(img) ^ mask);
+      }
+    }
+  oledEnd();
+  }
+
+/** Display a run length compressed graphic on the display
+ *
+ * Displays a compressed image in the same format used by lcdImageRleP(). The
+ * whole image is decoded and sent in a single I2C transaction. Images that
+ * will display off the edge of the screen are clipped, images with a width
+ * or height of zero are ignored.
+ *
+ * @param row the row number (0 to 7) to start the top left of the image.
+ * @param col the column number (0 to 127) to start the top left of the image.
+ * @param img pointer to the compressed image in PROGMEM.
+ * @param invert if true the pixel colors will be inverted.
+ */
+void oledImageRleP(uint8_t row, uint8_t col, const uint8_t *img, bool invert) {
+  if((row>=OLED_ROW)||(col>=OLED_COL))
+    return;
+  RLE_STATE rle;
+  uint8_t height, width;
+  if(!rleStartP(&rle, img, &height, &width))
+    return;
+  uint8_t mask = invert?0xFF:0x00;
+  oledWindow(col, width, row, height);
+  for(; (height>0)&&(row<OLED_ROW); height--, row++) {
+    // Send the data (up to the end of the screen)
+    for(uint8_t offset=0; offset<width; offset++) {
+      uint8_t data = rleNextP(&rle);
+      if((col+offset)<OLED_COL)
+        i2cWrite(data ^ mask);
+      }
+    }
+  oledEnd();
+  }
+
+// Only provide the functions if the driver is enabled
+#endif /* OLED_ENABLED */
@@ -0,0 +1,78 @@
+/*--------------------------------------------------------------------------*
+* Stack usage measurement
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Paints the unused RAM with a canary value before main() runs and scans
+* for it later to find out how deep the stack has grown.
+*--------------------------------------------------------------------------*/
+#include <avr/io.h>
+#include "../hardware.h"
+#include "utility.h"
+
+// Only if enabled
+#ifdef STACK_CHECK_ENABLED
+
+//! End of the static data (provided by the linker)
+extern uint8_t _end;
+
+//! Top of the stack (provided by the linker)
+extern uint8_t __stack;
+
+// Forward declaration with attributes to place it in the startup code
+void stackPaint() __attribute__ ((naked, used, section (".init1")));
+
+/** Fill unused RAM with the canary value
+ *
+ * This runs in the .init1 section, before the stack pointer and the zero
+ * register are set up, so it is written in assembly and only uses the Z
+ * pointer and two scratch registers. It is never called directly.
+ */
+void stackPaint() {
+  asm volatile(
+    "  ldi r30, lo8(_end)     \n\t"
+    "  ldi r31, hi8(_end)     \n\t"
+    "  ldi r24, %[canary]     \n\t"
+    "  ldi r25, hi8(__stack)  \n\t"
+    "  rjmp 2f                \n\t"
+    "1:                       \n\t"
+    "  st Z+, r24             \n\t"
+    "2:                       \n\t"
+    "  cpi r30, lo8(__stack)  \n\t"
+    "  cpc r31, r25           \n\t"
+    "  brlo 1b                \n\t"
+    "  breq 1b                \n\t"
+    :
+    : [canary] "M" (STACK_CANARY)
+    );
+  }
+
+/** Get the smallest amount of free RAM seen so far
+ *
+ * This is the gap between the end of the static data and the deepest point
+ * the stack has reached since reset.
+ *
+ * @return the number of bytes of RAM that have never been used.
+ */
+uint16_t ramUnused() {
+  const uint8_t *check = &_end;
+  while((check<=&__stack)&&(*check==STACK_CANARY))
+    check++;
+  return check - &_end;
+  }
+
+/** Get the maximum stack depth reached so far
+ *
+ * All RAM between the end of the static data and the top of the stack is
+ * filled with STACK_CANARY before main() is called. This scans up from the
+ * end of the static data to find the first byte that has been overwritten.
+ * The result is a lower bound - a value that happened to be written as
+ * STACK_CANARY will not be seen.
+ *
+ * @return the largest number of bytes of stack used since reset.
+ */
+uint16_t ramHighWater() {
+  return (&__stack - &_end) + 1 - ramUnused();
+  }
+
+#endif /* STACK_CHECK_ENABLED */
@@ -7,9 +7,13 @@
 *--------------------------------------------------------------------------*/
 #include <avr/io.h>
 #include <avr/interrupt.h>
+#include <avr/sleep.h>
 #include "../hardware.h"
 #include "systicks.h"
 #include "iohelp.h"
+#include "utility.h"
+#include "latency.h"
+#include "input.h"
 
 // Maximum number of software PWM outputs
 #define SPWM_MAX 4
@@ -17,6 +21,21 @@
 // Number of 'ticklets' per tick
 #define TICKLETS 64
 
+// Timer clock select bits for a prescaler of TICKS_FINE_CYCLES
+#if defined(TICKS_TIMER2)
+#  define TICKS_CLOCK_SELECT ((TICKS_FINE_CYCLES == 8)?2:1)
+#elif TICKS_FINE_CYCLES == 16
+#  define TICKS_CLOCK_SELECT 5
+#elif TICKS_FINE_CYCLES == 8
+#  define TICKS_CLOCK_SELECT 4
+#elif TICKS_FINE_CYCLES == 4
+#  define TICKS_CLOCK_SELECT 3
+#elif TICKS_FINE_CYCLES == 2
+#  define TICKS_CLOCK_SELECT 2
+#else
+#  define TICKS_CLOCK_SELECT 1
+#endif
+
 // If software PWM is enabled, we get systick as well
 #ifdef SOFTPWM_ENABLED
 #  define SYSTICK_ENABLED
@@ -47,19 +66,37 @@ static volatile uint8_t  g_ticklet = 0;
  * tracked by a 16 bit counter. A program can use the difference between
  * samples of the counter to measure longer periods of time.
  *
- * The ticks system uses TIMER1 to provide the interrupt used to update the
- * time count (this interrupt is shared with the software PWM implementation
- * as well).
+ * The ticks system uses TIMER1 (TIMER2 on the ATmega parts) to provide the
+ * interrupt used to update the time count (this interrupt is shared with the
+ * software PWM implementation as well).
  */
 void ticksInit() {
+#if defined(TICKS_TIMER2) && defined(TCCR2B)
+  // Stop timer and set normal mode
+  TCCR2B = 0;
+  TCCR2A = 0;
+  TCNT2 = 0;
+  TCCR2B = TICKS_CLOCK_SELECT; // Divide by TICKS_FINE_CYCLES
+#elif defined(TICKS_TIMER2)
+  // Stop timer and set normal mode
+  TCCR2 = 0;
+  TCNT2 = 0;
+  TCCR2 = TICKS_CLOCK_SELECT; // Divide by TICKS_FINE_CYCLES
+#else
   // Stop timer and clear prescaler
   TCCR1 = 0;
   TCNT1 = 0;
   GTCCR &= 0x81;
   GTCCR |= (1 << PSR1);
-  // Set up the prescaler and enable overflow interrupt
-  TCCR1 = (1 << CS12); // Divide by 8
-  TIMSK |= (1 << TOIE1);
+  // Set up the prescaler
+  TCCR1 = TICKS_CLOCK_SELECT; // Divide by TICKS_FINE_CYCLES
+#endif
+#ifdef LATENCY_ENABLED
+  // The compare flag marks the half way point for the latency measurements
+  TICKS_OCR = 0x80;
+#endif
+  // Enable the overflow interrupt
+  TICKS_TIMSK |= (1 << TICKS_TOIE);
   }
 
 /** Get the current tick count
@@ -88,6 +125,64 @@ uint16_t ticksElapsed(uint16_t reference) {
   return now - reference;
   }
 
+/** Get a high resolution time stamp
+ *
+ * Combines the current ticks timer count with the number of overflows to give
+ * a 16 bit time stamp with a resolution of TICKS_FINE_CYCLES CPU cycles
+ * (1us for the standard clock profiles). The value wraps around every 65536
+ * counts (about 65ms) so it is only suitable for measuring short intervals.
+ * This is safe to call from interrupt handlers.
+ *
+ * The ticks system must be running (call ticksInit() or spwmInit() first).
+ *
+ * @return the current time stamp.
+ */
+uint16_t ticksFine() {
+  LATENCY_SAVE(sreg);
+  uint8_t count = TICKS_TCNT;
+  // Overflow count from the low bits of the tick and ticklet counters
+  uint8_t overflows = ((uint8_t)g_systicks << 6) | (g_ticklet / (256 / TICKLETS));
+  // Allow for an overflow that has not been serviced yet
+  if((TICKS_TIFR & (1 << TICKS_TOV))&&(count<0x80))
+    overflows++;
+  LATENCY_RESTORE(sreg);
+  return ((uint16_t)overflows << 8) | count;
+  }
+
+// Number of timer overflows per second
+#define OVERFLOWS_PER_SECOND (F_CPU / (TICKS_FINE_CYCLES * 256UL))
+
+/** Sleep for a number of milliseconds
+ *
+ * Puts the CPU in idle mode between timer overflows until the requested
+ * time has elapsed. This uses far less power than wait() and other interrupts
+ * continue to be serviced during the delay. The resolution is one ticks timer
+ * overflow (256us for the standard clock profiles).
+ *
+ * The ticks system must be running (call ticksInit() or spwmInit() first)
+ * and interrupts must be enabled, if not this falls back to wait().
+ *
+ * @param millis the number of milliseconds to sleep for.
+ */
+void sleepMs(uint16_t millis) {
+  // Make sure we will actually wake up
+  if(!(TICKS_TIMSK & (1 << TICKS_TOIE))||!(SREG & (1 << SREG_I))) {
+    wait(millis);
+    return;
+    }
+  uint32_t overflows = (((uint32_t)millis * OVERFLOWS_PER_SECOND) + 999) / 1000;
+  uint8_t last = g_ticklet;
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  while(overflows>0) {
+    sleep_mode();
+    // We may have been woken by another interrupt, only count overflows
+    uint8_t now = g_ticklet;
+    uint8_t elapsed = (uint8_t)(now - last) / (256 / TICKLETS);
+    last = now;
+    overflows = (elapsed>=overflows)?0:(overflows - elapsed);
+    }
+  }
+
 #endif /* SYSTICK_ENABLED */
 
 //---------------------------------------------------------------------------
@@ -167,7 +262,8 @@ uint8_t spwmValue(SPWM pwm) {
 
 /** Interrupt handler
  */
-ISR(TIMER1_OVF_vect) {
+ISR(TICKS_vect) {
+  LATENCY_ISR();
   // Update the 'ticklet' count
   g_ticklet += (256 / TICKLETS);
 #ifdef SOFTPWM_ENABLED
@@ -201,6 +297,10 @@ ISR(TIMER1_OVF_vect) {
     return;
   // If 'ticklet' wraps around, update the tick count
   g_systicks++;
+#ifdef INPUT_ENABLED
+  // Sample the debounced inputs
+  inputTick();
+#endif
   }
 
 #endif /* SOFTPWM_ENABLED || SYSTICK_ENABLED */
@@ -0,0 +1,57 @@
+/*--------------------------------------------------------------------------*
+* Cooperative task scheduler
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Simple round robin scheduler for the tasks defined in task.h. Tasks are
+* called in order on every pass, the pass only sleeps when none of them
+* could make progress.
+*--------------------------------------------------------------------------*/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include "../hardware.h"
+#include "task.h"
+
+// Only if enabled
+#ifdef TASK_ENABLED
+
+/** Run a set of tasks
+ *
+ * Initialises the tasks and calls each of them in turn until they have all
+ * finished. When a complete pass finds every task waiting the CPU is put
+ * in idle mode until the next interrupt (with TASK_IDLE_SLEEP defined and
+ * the ticks system running). A condition set outside an interrupt handler
+ * is seen on the next timer overflow (every 256us at 8MHz).
+ *
+ * @param pFuncs the task functions.
+ * @param pTasks the state for each task (one entry for each function).
+ * @param count the number of tasks.
+ */
+void taskRun(const TASK_FUNC *pFuncs, TASK *pTasks, uint8_t count) {
+  uint8_t index;
+  for(index=0; index<count; index++)
+    TASK_INIT(&pTasks[index]);
+#ifdef TASK_IDLE_SLEEP
+  set_sleep_mode(SLEEP_MODE_IDLE);
+#endif
+  while(true) {
+    bool running = false, yielded = false;
+    for(index=0; index<count; index++) {
+      uint8_t status = (*pFuncs[index])(&pTasks[index]);
+      if(status!=TASK_EXITED)
+        running = true;
+      if(status==TASK_YIELDED)
+        yielded = true;
+      }
+    if(!running)
+      return;
+#ifdef TASK_IDLE_SLEEP
+    // Only sleep if the ticks timer will wake us up
+    if(!yielded && (TICKS_TIMSK & (1 << TICKS_TOIE)) && (SREG & (1 << SREG_I)))
+      sleep_mode();
+#endif
+    }
+  }
+
+#endif /* TASK_ENABLED */
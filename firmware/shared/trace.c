@@ -0,0 +1,136 @@
+/*--------------------------------------------------------------------------*
+* Event tracing implementation
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Records are held in a RAM ring buffer. The producer (traceAdd()) only
+* changes the head index and the consumer (traceDrain()) only changes the
+* tail index so records can be added from interrupt handlers while the
+* buffer is being drained.
+*--------------------------------------------------------------------------*/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "../hardware.h"
+#include "softuart.h"
+#include "systicks.h"
+#include "utility.h"
+#include "latency.h"
+#include "trace.h"
+
+// Only if enabled
+#ifdef TRACE_ENABLED
+
+// Make sure the buffer size is valid
+#if (TRACE_RECORDS < 2) || (TRACE_RECORDS > 128) || (TRACE_RECORDS & (TRACE_RECORDS - 1))
+#  error "TRACE_RECORDS must be a power of two between 2 and 128"
+#endif
+
+// Mask for buffer indexes
+#define TRACE_MASK (TRACE_RECORDS - 1)
+
+/** A single trace record
+ */
+typedef struct _TRACE_RECORD {
+  uint8_t  id;    //!< Event identifier
+  uint8_t  value; //!< Event value
+  uint16_t stamp; //!< Time stamp (from ticksFine())
+  } TRACE_RECORD;
+
+//! The ring buffer
+static TRACE_RECORD g_trace[TRACE_RECORDS];
+
+//! Index of the next record to write
+static volatile uint8_t g_traceHead = 0;
+
+//! Index of the next record to send
+static volatile uint8_t g_traceTail = 0;
+
+//! Number of records dropped since the last drain
+static volatile uint8_t g_traceDropped = 0;
+
+/** Add a record to the trace buffer
+ *
+ * Stores the id and value along with the current time stamp (see
+ * ticksFine()). This is safe to call from interrupt handlers. If the buffer
+ * is full the record is discarded and counted as dropped. Use the TRACE()
+ * macro rather than calling this directly so the call is removed when
+ * tracing is not enabled.
+ *
+ * @param id an identifier for the event.
+ * @param value a value associated with the event.
+ */
+void traceAdd(uint8_t id, uint8_t value) {
+  LATENCY_SAVE(sreg);
+  uint8_t head = g_traceHead;
+  uint8_t next = (head + 1) & TRACE_MASK;
+  if(next==g_traceTail) {
+    if(g_traceDropped<0xFF)
+      g_traceDropped++;
+    }
+  else {
+    TRACE_RECORD *record = &g_trace[head];
+    record->id = id;
+    record->value = value;
+    record->stamp = ticksFine();
+    g_traceHead = next;
+    }
+  LATENCY_RESTORE(sreg);
+  }
+
+/** Send a byte and add it to the CRC
+ *
+ * @param crc the current CRC value.
+ * @param data the byte to send.
+ *
+ * @return the updated CRC value.
+ */
+static uint16_t traceSend(uint16_t crc, uint8_t data) {
+  uartSend(data);
+  return crcByte(crc, data);
+  }
+
+/** Send all buffered records over the UART
+ *
+ * The records are sent as a single binary frame and removed from the buffer.
+ * The frame format is:
+ *
+ *   'T' 'R' count dropped [id value stamp_low stamp_high] * count crc_high crc_low
+ *
+ * Where 'dropped' is the number of records discarded since the last frame
+ * (up to 255) and the CRC (see crcByte()) covers the count, dropped and
+ * record bytes. Nothing is sent if the buffer is empty and no records have
+ * been dropped.
+ *
+ * @return the number of records sent.
+ */
+uint8_t traceDrain() {
+  // Take a snapshot of the buffer state
+  LATENCY_SAVE(sreg);
+  uint8_t tail = g_traceTail;
+  uint8_t head = g_traceHead;
+  uint8_t dropped = g_traceDropped;
+  g_traceDropped = 0;
+  LATENCY_RESTORE(sreg);
+  uint8_t count = (head - tail) & TRACE_MASK;
+  if((count==0)&&(dropped==0))
+    return 0;
+  // Send the frame
+  uartSend('T');
+  uartSend('R');
+  uint16_t crc = traceSend(crcInit(), count);
+  crc = traceSend(crc, dropped);
+  for(uint8_t index=0; index<count; index++) {
+    TRACE_RECORD *record = &g_trace[(tail + index) & TRACE_MASK];
+    crc = traceSend(crc, record->id);
+    crc = traceSend(crc, record->value);
+    crc = traceSend(crc, record->stamp & 0xFF);
+    crc = traceSend(crc, record->stamp >> 8);
+    }
+  uartSend(crc >> 8);
+  uartSend(crc & 0xFF);
+  // Release the records we sent
+  g_traceTail = head;
+  return count;
+  }
+
+#endif /* TRACE_ENABLED */
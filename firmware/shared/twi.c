@@ -0,0 +1,226 @@
+/*--------------------------------------------------------------------------*
+* I2C (TWI) master
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* An I2C master using the USI module in two wire mode. The USI does the
+* shifting, the code generates the clock edges and waits for SCL to go high
+* after each rising edge so slaves can stretch the clock. Based on the
+* approach described in Atmel application note AVR310.
+*--------------------------------------------------------------------------*/
+#include <avr/io.h>
+#include "../hardware.h"
+#include "iohelp.h"
+#include "utility.h"
+
+// USI pins (fixed by hardware)
+#define TWI_SDA PINB0
+#define TWI_SCL PINB2
+
+// Bus timing (low and high clock periods)
+#if TWI_SPEED > 100000
+#  define TWI_DELAY_LOW()  delayUs(1.3)
+#  define TWI_DELAY_HIGH() delayUs(0.6)
+#else
+#  define TWI_DELAY_LOW()  delayUs(4.7)
+#  define TWI_DELAY_HIGH() delayUs(4.0)
+#endif
+
+// Clear all flags and set the counter to overflow after 8 bits (16 edges)
+#define USISR_8BIT ((1 << USISIF) | (1 << USIOIF) | (1 << USIPF) | (1 << USIDC) | (0x00 << USICNT0))
+
+// Clear all flags and set the counter to overflow after 1 bit (2 edges)
+#define USISR_1BIT ((1 << USISIF) | (1 << USIOIF) | (1 << USIPF) | (1 << USIDC) | (0x0E << USICNT0))
+
+// Two wire mode, software clock strobe
+#define USICR_MASTER ((1 << USIWM1) | (1 << USICS1) | (1 << USICLK))
+
+/** Wait for SCL to be released
+ *
+ * Slaves may hold SCL low to stretch the clock.
+ */
+static void twiWaitClock() {
+  while(!(PINB & (1 << TWI_SCL)));
+  }
+
+/** Clock data through the USI
+ *
+ * @param status the value to load into USISR (determines the bit count).
+ *
+ * @return the contents of the data register after the transfer.
+ */
+static uint8_t twiTransfer(uint8_t status) {
+  USISR = status;
+  do {
+    TWI_DELAY_LOW();
+    // Rising edge, wait for any clock stretching
+    USICR = USICR_MASTER | (1 << USITC);
+    twiWaitClock();
+    TWI_DELAY_HIGH();
+    // Falling edge
+    USICR = USICR_MASTER | (1 << USITC);
+    }
+  while(!(USISR & (1 << USIOIF)));
+  TWI_DELAY_LOW();
+  uint8_t data = USIDR;
+  // Release SDA
+  USIDR = 0xFF;
+  DDRB |= (1 << TWI_SDA);
+  return data;
+  }
+
+/** Send a single byte and check for an acknowledgement
+ *
+ * @param data the byte to send.
+ *
+ * @return true if the slave acknowledged the byte.
+ */
+static bool twiSendByte(uint8_t data) {
+  PORTB &= ~(1 << TWI_SCL);
+  USIDR = data;
+  twiTransfer(USISR_8BIT);
+  // Read the acknowledge bit
+  DDRB &= ~(1 << TWI_SDA);
+  return !(twiTransfer(USISR_1BIT) & 0x01);
+  }
+
+/** Receive a single byte
+ *
+ * @param last true if this is the last byte (it will not be acknowledged).
+ *
+ * @return the byte received.
+ */
+static uint8_t twiRecvByte(bool last) {
+  DDRB &= ~(1 << TWI_SDA);
+  uint8_t data = twiTransfer(USISR_8BIT);
+  // Send ACK (or NACK for the last byte)
+  USIDR = last?0xFF:0x00;
+  twiTransfer(USISR_1BIT);
+  return data;
+  }
+
+/** Generate a start (or repeated start) condition and send the address
+ *
+ * @param address the address byte (including the read/write bit).
+ *
+ * @return true if the slave acknowledged the address.
+ */
+static bool twiStart(uint8_t address) {
+  // Release SCL and wait for it to go high
+  PORTB |= (1 << TWI_SCL);
+  twiWaitClock();
+  TWI_DELAY_LOW();
+  // SDA low while SCL is high
+  PORTB &= ~(1 << TWI_SDA);
+  TWI_DELAY_HIGH();
+  PORTB &= ~(1 << TWI_SCL);
+  PORTB |= (1 << TWI_SDA);
+  return twiSendByte(address);
+  }
+
+/** Generate a stop condition
+ */
+static void twiStop() {
+  PORTB &= ~(1 << TWI_SDA);
+  PORTB |= (1 << TWI_SCL);
+  twiWaitClock();
+  TWI_DELAY_HIGH();
+  PORTB |= (1 << TWI_SDA);
+  TWI_DELAY_LOW();
+  }
+
+/** Initialise the I2C master
+ *
+ * Sets up the USI in two wire mode and releases both bus lines. The bus
+ * speed is set by TWI_SPEED in @ref hardware.h.
+ */
+void twiInit() {
+  uint8_t val = (1 << TWI_SDA) | (1 << TWI_SCL);
+  PORTB |= val;
+  DDRB |= val;
+  USIDR = 0xFF;
+  USICR = USICR_MASTER;
+  USISR = USISR_8BIT;
+  }
+
+/** Write a block of data to a slave
+ *
+ * @param addr the 7 bit address of the slave.
+ * @param data pointer to the data to send.
+ * @param length the number of bytes to send.
+ *
+ * @return true if all bytes were acknowledged.
+ */
+bool twiWrite(uint8_t addr, const uint8_t *data, uint8_t length) {
+  bool ok = twiStart(addr << 1);
+  for(; ok && (length>0); length--, data++)
+    ok = twiSendByte(*data);
+  twiStop();
+  return ok;
+  }
+
+/** Read a block of data from a slave
+ *
+ * All bytes except the last are acknowledged. Nothing is sent on the bus
+ * if the length is zero.
+ *
+ * @param addr the 7 bit address of the slave.
+ * @param data pointer to the buffer to receive the data.
+ * @param length the number of bytes to read.
+ *
+ * @return true if the slave acknowledged the address (always true if the
+ *         length is zero).
+ */
+bool twiRead(uint8_t addr, uint8_t *data, uint8_t length) {
+  // A read must end with a NACK so there has to be at least one byte
+  if(length==0)
+    return true;
+  bool ok = twiStart((addr << 1) | 0x01);
+  for(; ok && (length>0); length--, data++)
+    *data = twiRecvByte(length==1);
+  twiStop();
+  return ok;
+  }
+
+/** Write a block of data to a slave register
+ *
+ * Sends the register address followed by the data in a single transaction.
+ * Most devices will auto increment the register address for each byte.
+ *
+ * @param addr the 7 bit address of the slave.
+ * @param reg the register address to write to.
+ * @param data pointer to the data to send.
+ * @param length the number of bytes to send.
+ *
+ * @return true if all bytes were acknowledged.
+ */
+bool twiWriteReg(uint8_t addr, uint8_t reg, const uint8_t *data, uint8_t length) {
+  bool ok = twiStart(addr << 1) && twiSendByte(reg);
+  for(; ok && (length>0); length--, data++)
+    ok = twiSendByte(*data);
+  twiStop();
+  return ok;
+  }
+
+/** Read a block of data from a slave register
+ *
+ * Sends the register address then uses a repeated start to read the data so
+ * the whole operation is a single transaction. If the length is zero only
+ * the register address is sent.
+ *
+ * @param addr the 7 bit address of the slave.
+ * @param reg the register address to read from.
+ * @param data pointer to the buffer to receive the data.
+ * @param length the number of bytes to read.
+ *
+ * @return true if the slave acknowledged the address and register.
+ */
+bool twiReadReg(uint8_t addr, uint8_t reg, uint8_t *data, uint8_t length) {
+  bool ok = twiStart(addr << 1) && twiSendByte(reg);
+  if(length>0)
+    ok = ok && twiStart((addr << 1) | 0x01);
+  for(; ok && (length>0); length--, data++)
+    *data = twiRecvByte(length==1);
+  twiStop();
+  return ok;
+  }
@@ -0,0 +1,206 @@
+/*--------------------------------------------------------------------------*
+* I2C (TWI) slave
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* An interrupt driven I2C slave using the USI module that exposes a block of
+* RAM registers. The state machine follows the approach described in Atmel
+* application note AVR312. Every byte is handled inside the USI interrupts
+* so the main program is never involved in bus traffic.
+*--------------------------------------------------------------------------*/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "../hardware.h"
+#include "iohelp.h"
+#include "latency.h"
+
+// Only if enabled
+#ifdef TWI_SLAVE_ENABLED
+
+// Make sure the register count is sensible
+#if (TWI_SLAVE_REGISTERS < 1) || (TWI_SLAVE_REGISTERS > 256)
+#  error "TWI_SLAVE_REGISTERS must be between 1 and 256"
+#endif
+
+// USI pins (fixed by hardware)
+#define TWI_SDA PINB0
+#define TWI_SCL PINB2
+
+// Clear all flags and set the counter to overflow after 8 bits (16 edges)
+#define USISR_8BIT ((1 << USISIF) | (1 << USIOIF) | (1 << USIPF) | (1 << USIDC) | (0x00 << USICNT0))
+
+// Clear all flags and set the counter to overflow after 1 bit (2 edges)
+#define USISR_1BIT ((1 << USISIF) | (1 << USIOIF) | (1 << USIPF) | (1 << USIDC) | (0x0E << USICNT0))
+
+// Wait for a start condition only
+#define USICR_START ((1 << USISIE) | (1 << USIWM1) | (1 << USICS1))
+
+// Start and overflow interrupts, hold SCL low on overflow
+#define USICR_ACTIVE ((1 << USISIE) | (1 << USIOIE) | (1 << USIWM1) | (1 << USIWM0) | (1 << USICS1))
+
+/** Slave states
+ *
+ * The state indicates what to do when the next USI counter overflow occurs.
+ */
+typedef enum _TWI_STATE {
+  TWI_CHECK_ADDRESS,  //!< Address byte has been received
+  TWI_SEND_DATA,      //!< Load the next byte for the master to read
+  TWI_REQUEST_REPLY,  //!< Data byte sent, wait for the ACK/NACK
+  TWI_CHECK_REPLY,    //!< ACK/NACK received from the master
+  TWI_REQUEST_DATA,   //!< Wait for the next byte from the master
+  TWI_GET_DATA,       //!< Byte received from the master
+  } TWI_STATE;
+
+//! The register values
+static volatile uint8_t g_registers[TWI_SLAVE_REGISTERS];
+
+//! The current register pointer
+static volatile uint8_t g_pointer = 0;
+
+//! Current state
+static volatile uint8_t g_state = TWI_CHECK_ADDRESS;
+
+//! True if the next byte written by the master is the register pointer
+static volatile bool g_first = false;
+
+/** Return to waiting for a start condition
+ */
+static void twiSlaveReset() {
+  USICR = USICR_START;
+  USISR = (1 << USIOIF) | (1 << USIPF) | (1 << USIDC);
+  }
+
+/** Acknowledge the byte just received
+ */
+static void twiSlaveAck() {
+  USIDR = 0;
+  DDRB |= (1 << TWI_SDA);
+  USISR = USISR_1BIT;
+  }
+
+/** Initialise the I2C slave
+ *
+ * Sets up the USI to wait for a start condition and clears the registers.
+ * The address and number of registers are set in @ref hardware.h. Interrupts
+ * must be enabled for the slave to respond.
+ */
+void twiSlaveInit() {
+  for(uint16_t index=0; index<TWI_SLAVE_REGISTERS; index++)
+    g_registers[index] = 0;
+  // SCL is an output (the USI holds it low when needed), SDA is an input
+  PORTB |= (1 << TWI_SDA) | (1 << TWI_SCL);
+  DDRB |= (1 << TWI_SCL);
+  DDRB &= ~(1 << TWI_SDA);
+  USICR = USICR_START;
+  USISR = USISR_8BIT;
+  }
+
+/** Get the current value of a slave register
+ *
+ * @param reg the register number.
+ *
+ * @return the current value of the register (0 for an invalid register).
+ */
+uint8_t twiRegGet(uint8_t reg) {
+  if(reg<TWI_SLAVE_REGISTERS)
+    return g_registers[reg];
+  return 0;
+  }
+
+/** Set the value of a slave register
+ *
+ * @param reg the register number. Invalid registers are ignored.
+ * @param value the new value for the register.
+ */
+void twiRegSet(uint8_t reg, uint8_t value) {
+  if(reg<TWI_SLAVE_REGISTERS)
+    g_registers[reg] = value;
+  }
+
+/** Start condition
+ *
+ * Waits for the master to bring SCL low (or for a stop condition) and then
+ * arms the counter to receive the address byte.
+ */
+ISR(USI_START_vect) {
+  LATENCY_ISR();
+  g_state = TWI_CHECK_ADDRESS;
+  DDRB &= ~(1 << TWI_SDA);
+  // Wait for SCL to go low, a rising SDA means a stop condition instead
+  while((PINB & (1 << TWI_SCL))&&!(PINB & (1 << TWI_SDA)));
+  if(PINB & (1 << TWI_SDA))
+    USICR = USICR_START;
+  else
+    USICR = USICR_ACTIVE;
+  USISR = USISR_8BIT;
+  }
+
+/** Counter overflow
+ *
+ * Called after every byte and every ACK/NACK bit. SCL is held low until the
+ * counter is reloaded so the master waits while this runs.
+ */
+ISR(USI_OVF_vect) {
+  LATENCY_ISR();
+  uint8_t data;
+  switch(g_state) {
+    case TWI_CHECK_ADDRESS:
+      data = USIDR;
+      if((data >> 1)!=TWI_SLAVE_ADDRESS) {
+        twiSlaveReset();
+        return;
+        }
+      if(data & 0x01)
+        g_state = TWI_SEND_DATA;
+      else {
+        g_state = TWI_REQUEST_DATA;
+        g_first = true;
+        }
+      twiSlaveAck();
+      break;
+    case TWI_CHECK_REPLY:
+      // A NACK means the master does not want any more data
+      if(USIDR) {
+        twiSlaveReset();
+        return;
+        }
+      // Fall through to send the next byte
+    case TWI_SEND_DATA:
+      data = g_pointer;
+      USIDR = g_registers[data];
+      if(++data>=TWI_SLAVE_REGISTERS)
+        data = 0;
+      g_pointer = data;
+      DDRB |= (1 << TWI_SDA);
+      USISR = USISR_8BIT;
+      g_state = TWI_REQUEST_REPLY;
+      break;
+    case TWI_REQUEST_REPLY:
+      DDRB &= ~(1 << TWI_SDA);
+      USIDR = 0;
+      USISR = USISR_1BIT;
+      g_state = TWI_CHECK_REPLY;
+      break;
+    case TWI_REQUEST_DATA:
+      DDRB &= ~(1 << TWI_SDA);
+      USISR = USISR_8BIT;
+      g_state = TWI_GET_DATA;
+      break;
+    case TWI_GET_DATA:
+      data = USIDR;
+      if(g_first) {
+        g_pointer = (data<TWI_SLAVE_REGISTERS)?data:0;
+        g_first = false;
+        }
+      else {
+        g_registers[g_pointer] = data;
+        if(++g_pointer>=TWI_SLAVE_REGISTERS)
+          g_pointer = 0;
+        }
+      g_state = TWI_REQUEST_DATA;
+      twiSlaveAck();
+      break;
+    }
+  }
+
+#endif /* TWI_SLAVE_ENABLED */
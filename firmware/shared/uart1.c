@@ -0,0 +1,45 @@
+/*--------------------------------------------------------------------------*
+* Second software UART channel
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* A second two pin, interrupt driven UART on its own pair of pins. The code
+* is generated from uart_channel.h with the pins and baud rate set in
+* 'hardware.h' so the bit banging still uses single cycle port access.
+*
+* Both channels share PCINT0_vect through the dispatcher in pcint.c, the
+* main UART is serviced first. The channel is listed in UART_CHANNELS (see
+* softuart.h) which generates its prototypes and the dispatcher call. Only
+* one byte can be received at a time - see the notes in 'hardware.h' for
+* the throughput and latency limits when both channels are active.
+*--------------------------------------------------------------------------*/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "../hardware.h"
+#include "uart_defs.h"
+#include "softuart.h"
+#include "latency.h"
+
+// Only if enabled
+#ifdef UART1_ENABLED
+
+// Channel parameters
+#define UART_CH(name)  uart1##name
+#define UART_CH_TX     UART1_TX
+#define UART_CH_RX     UART1_RX
+#define UART_CH_BAUD   UART1_BAUD_RATE
+#define UART_CH_BUFFER UART1_BUFFER
+
+// First in UART_CHANNELS so only the main UART is checked before it, and
+// only when it is interrupt driven (the one pin UART is not unless the bus
+// is enabled).
+#if defined(UART_ENABLED) && defined(UART_INTERRUPT)
+#  define UART_CH_ENTRY (PCINT_ENTRY + PCINT_SKIP)
+#else
+#  define UART_CH_ENTRY PCINT_ENTRY
+#endif
+
+// Generate the implementation
+#include "uart_channel.h"
+
+#endif /* UART1_ENABLED */
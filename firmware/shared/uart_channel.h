@@ -0,0 +1,171 @@
+/*--------------------------------------------------------------------------*
+* Additional software UART channel template
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Generates the functions for an additional two pin, interrupt driven UART
+* channel. This file has no include guard - it is included once by each
+* channel implementation (see uart1.c) after defining:
+*
+*   UART_CH(name) - makes the function names (eg: uart1##name)
+*   UART_CH_TX    - the transmit pin
+*   UART_CH_RX    - the receive pin
+*   UART_CH_BAUD  - the baud rate
+*   UART_CH_BUFFER - the size of the receive buffer
+*   UART_CH_ENTRY - delay units (3 cycles each) to allow for the time taken
+*                   to reach the receive code after the start bit, this is
+*                   PCINT_ENTRY plus PCINT_SKIP for every handler the
+*                   dispatcher calls first (see uart_defs.h)
+*
+* The pins are compile time constants so the generated code uses sbi/cbi
+* and sbic directly, exactly like the main channel. Receiving is handled by
+* UART_CH(PinChange)() which is called from the pin change dispatcher (see
+* pcint.c) so PCINT_ENABLED is required. The channel must also be added to
+* UART_CHANNELS in softuart.h for the prototypes and the dispatcher call.
+*--------------------------------------------------------------------------*/
+
+// Sanity checks
+#if UART_CH_TX == UART_CH_RX
+#  error "Additional UART channels need separate TX and RX pins"
+#endif
+#ifndef PCINT_ENABLED
+#  error "Additional UART channels need PCINT_ENABLED"
+#endif
+
+// LATENCY_ISR() in the dispatcher also runs before the start bit is sampled
+#ifdef LATENCY_ENABLED
+#  define UART_CH_LATENCY ((LATENCY_ISR_CYCLES + 2) / 3)
+#else
+#  define UART_CH_LATENCY 0
+#endif
+
+// Delays for this channel (see uart_defs.h)
+#define UART_CH_TXDELAY  (((F_CPU/UART_CH_BAUD)-7)/3)
+#define UART_CH_TXPAD    (((F_CPU/UART_CH_BAUD)-7)%3)
+#define UART_CH_RXDELAY  (int)(((F_CPU/UART_CH_BAUD)-5 +1.5)/3)
+#define UART_CH_RXDELAY2 (int)(((UART_CH_RXDELAY*1.5)-2.5) - UART_CH_ENTRY - UART_CH_LATENCY)
+#if (((F_CPU/UART_CH_BAUD)-5 +2)/3) > 127
+#  error low baud rates unsupported - use a higher baud rate for this channel
+#endif
+#if (3*((2*(F_CPU/UART_CH_BAUD)-7)/6)) < (2*(UART_CH_ENTRY + UART_CH_LATENCY) + 7)
+#  error high baud rates unsupported - use a lower baud rate for this channel
+#endif
+
+//! The receive buffer
+static uint8_t g_buffer[UART_CH_BUFFER];
+
+//! Number of characters in the buffer
+static volatile uint8_t g_index = 0;
+
+/** Initialise the channel
+ */
+void UART_CH(Init)() {
+  // Set RX as input and disable pullup
+  DDRB  &= ~(1 << UART_CH_RX);
+  PORTB &= ~(1 << UART_CH_RX);
+  // Set up TX pin
+  DDRB |= (1 << UART_CH_TX);
+  PORTB |= (1 << UART_CH_TX);
+  // Enable pin change interrupts
+  PCMSK |= (1 << UART_CH_RX);
+  GIMSK |= (1 << PCIE);
+  }
+
+/** Write a single character
+ *
+ * @param ch the character to send.
+ */
+void UART_CH(Send)(char ch) {
+  LATENCY_CLI();
+  asm volatile(
+    "  cbi %[uart_port], %[uart_pin]    \n\t"  // start bit
+    "  in r0, %[uart_port]              \n\t"
+    "  ldi r30, 3                       \n\t"  // stop bit + idle state
+    "  ldi r28, %[txdelay]              \n\t"
+    "1:                                 \n\t"
+    // 8 cycle loop + delay - total = 7 + 3*r22 + padding
+    "  mov r29, r28                     \n\t"
+    "2:                                 \n\t"
+    // delay (3 cycle * delayCount) - 1
+    "  dec r29                          \n\t"
+    "  brne 2b                          \n\t"
+    "  bst %[ch], 0                     \n\t"
+    "  bld r0, %[uart_pin]              \n\t"
+    "  lsr r30                          \n\t"
+    "  ror %[ch]                        \n\t"
+    "  out %[uart_port], r0             \n\t"
+    "  .rept %[txpad]                   \n\t"  // round to the exact bit time
+    "  nop                              \n\t"
+    "  .endr                            \n\t"
+    "  brne 1b                          \n\t"
+    :
+    : [uart_port] "I" (_SFR_IO_ADDR(PORTB)),
+      [uart_pin] "I" (UART_CH_TX),
+      [txdelay] "M" (UART_CH_TXDELAY),
+      [txpad] "M" (UART_CH_TXPAD),
+      [ch] "r" (ch)
+    : "r0","r28","r29","r30");
+  LATENCY_SEI();
+  }
+
+/** Determine if characters are available
+ *
+ * @return the number of characters available in the input buffer.
+ */
+uint8_t UART_CH(Avail)() {
+  return g_index;
+  }
+
+/** Receive a single character
+ *
+ * Wait for a single character on the channel and return it.
+ *
+ * @return the character received.
+ */
+char UART_CH(Recv)() {
+  char ch;
+  // Wait for a character
+  while(g_index==0);
+  LATENCY_CLI();
+  // Return the first character in the buffer
+  ch = g_buffer[0];
+  g_index--;
+  // Move everything down
+  for(uint8_t index=0; index<g_index; g_buffer[index] = g_buffer[index + 1], index++);
+  LATENCY_SEI();
+  return ch;
+  }
+
+/** Pin change handler, called by the dispatcher in pcint.c
+ */
+void UART_CH(PinChange)() {
+  uint8_t ch;
+  // Make sure it is our pin and it is 0
+  if(PINB&(1<<UART_CH_RX))
+    return;
+  asm volatile(
+    "  ldi r18, %[rxdelay2]              \n\t" // 1.5 bit delay
+    "  ldi %0, 0x80                      \n\t" // bit shift counter
+    "1:                                  \n\t"
+    // 6 cycle loop + delay - total = 5 + 3*r22
+    // delay (3 cycle * r18) -1 and clear carry with subi
+    "  subi r18, 1                       \n\t"
+    "  brne 1b                           \n\t"
+    "  ldi r18, %[rxdelay]               \n\t"
+    "  sbic %[uart_port]-2, %[uart_pin]  \n\t" // check UART PIN
+    "  sec                               \n\t"
+    "  ror %0                            \n\t"
+    "  brcc 1b                           \n\t"
+    "2:                                  \n\t"
+    "  dec r18                           \n\t"
+    "  brne 2b                           \n\t"
+    : "=r" (ch)
+    : [uart_port] "I" (_SFR_IO_ADDR(PORTB)),
+      [uart_pin] "I" (UART_CH_RX),
+      [rxdelay] "M" (UART_CH_RXDELAY),
+      [rxdelay2] "M" (UART_CH_RXDELAY2)
+    : "r0","r18","r19");
+  // Now put it in the buffer (if we have room)
+  if(g_index<UART_CH_BUFFER)
+    g_buffer[g_index++] = ch;
+  }
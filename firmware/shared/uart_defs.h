@@ -12,28 +12,73 @@
 // See what mode we are in
 #if UART_TX == UART_RX
 #  define UART_ONEPIN
-#  undef  UART_INTERRUPT
+   // Only the multi-drop bus receives by interrupt on a single pin
+#  ifndef BUS_ENABLED
+#    undef  UART_INTERRUPT
+#  endif
 #else
 #  define UART_TWOPIN
 #endif
 
 // Calculate delays for the bit bashing functions
 #ifdef F_CPU
+   // Transmit loop is 7 cycles + 3 per delay count + up to 2 padding cycles
+#  define TXDELAY   (((F_CPU/BAUD_RATE)-7)/3)
+#  define TXPAD     (((F_CPU/BAUD_RATE)-7)%3)
 /* account for integer truncation by adding 3/2 = 1.5 */
-#  define TXDELAY   (int)(((F_CPU/BAUD_RATE)-7 +1.5)/3)
 #  define RXDELAY   (int)(((F_CPU/BAUD_RATE)-5 +1.5)/3)
-#  ifdef UART_INTERRUPT
+   // Delay units before the first handler called by the pin change
+   // dispatcher starts reading, and for each handler before it that
+   // returns early (see uart_channel.h)
+#  define PCINT_ENTRY 16
+#  define PCINT_SKIP  4
+#  if defined(UART_INTERRUPT) && defined(PCINT_ENABLED)
+     // The pin change dispatcher adds about 24 cycles before the read starts
+#    define RXENTRY PCINT_ENTRY
+#  elif defined(UART_INTERRUPT)
      // Reduce the stop bit delay to allow for ISR entry code
-#    define RXDELAY2  (int)(((RXDELAY*1.5)-2.5) - 8)
+#    define RXENTRY 8
+#  else
+#    define RXENTRY 0
+#  endif
+#  if defined(UART_INTERRUPT) && defined(LATENCY_ENABLED)
+     // LATENCY_ISR() runs before the start bit is sampled
+#    include "latency.h"
+#    define RXLATENCY ((LATENCY_ISR_CYCLES + 2) / 3)
 #  else
-#    define RXDELAY2  (int)((RXDELAY*1.5)-2.5)
+#    define RXLATENCY 0
 #  endif
+#  define RXDELAY2  (int)(((RXDELAY*1.5)-2.5) - RXENTRY - RXLATENCY)
+   // Bus transmit loop is 12 cycles + delays with the line sampled between them
+#  define BUSDELAY  (int)(((F_CPU/BAUD_RATE)-12 +1.5)/3)
+#  define BUSDELAY1 (BUSDELAY/2)
+#  define BUSDELAY2 (BUSDELAY - BUSDELAY1)
 #  define RXROUNDED (((F_CPU/BAUD_RATE)-5 +2)/3)
 #  if RXROUNDED > 127
 #    error low baud rates unsupported - use higher BAUD_RATE
+#  endif
+   // Same as RXDELAY2 < 1 using integer arithmetic
+#  if (3*((2*(F_CPU/BAUD_RATE)-7)/6)) < (2*(RXENTRY + RXLATENCY) + 7)
+#    error high baud rates unsupported - use lower BAUD_RATE
 #  endif
 #else
 #  error CPU frequency F_CPU undefined
 #endif
 
+#ifdef BUS_ENABLED
+#include <stdint.h>
+#include <stdbool.h>
+#include "bus.h"
+
+// Receive filter states
+#  define BUS_IGNORE  0 // Waiting for the start of a frame
+#  define BUS_ADDRESS 1 // Next byte is the address
+#  define BUS_ACCEPT  2 // Frame is for this node
+
+// Bus state shared with bus.c
+extern uint8_t g_busAddress;
+extern volatile uint8_t g_busState;
+extern volatile bool g_busCollision;
+#endif
+
 #endif /* __UART_DEFS_H */
@@ -21,6 +21,7 @@
 #include "../hardware.h"
 #include "uart_defs.h"
 #include "softuart.h"
+#include "latency.h"
 
 // Only if enabled
 #ifdef UART_ENABLED
@@ -67,20 +68,20 @@ char uartRecv() {
 #ifdef UART_INTERRUPT
   // Wait for a character
   while(g_index==0);
-  cli();
+  LATENCY_CLI();
   // Return the first character in the buffer
   ch = g_buffer[0];
   g_index--;
   // Move everything down
   for(uint8_t index=0; index<g_index; g_buffer[index] = g_buffer[index + 1], index++);
   // Done
-  sei();
+  LATENCY_SEI();
 #else
   // Set as input and disable pullup
   DDRB  &= ~(1 << UART_RX);
   PORTB &= ~(1 << UART_RX);
   // Read the byte
-  cli();
+  LATENCY_CLI();
   asm volatile(
     "  ldi r18, %[rxdelay2]              \n\t" // 1.5 bit delay
     "  ldi %0, 0x80                      \n\t" // bit shift counter
@@ -103,18 +104,25 @@ char uartRecv() {
     : "=r" (ch)
     : [uart_port] "I" (_SFR_IO_ADDR(PORTB)),
       [uart_pin] "I" (UART_RX),
-      [rxdelay] "I" (RXDELAY),
-      [rxdelay2] "I" (RXDELAY2)
+      [rxdelay] "M" (RXDELAY),
+      [rxdelay2] "M" (RXDELAY2)
     : "r0","r18","r19");
-  sei();
+  LATENCY_SEI();
 #endif
   return ch;
   }
 
 #ifdef UART_INTERRUPT
+#  ifdef PCINT_ENABLED
+/* Pin change handler, called first by the dispatcher in pcint.c
+ */
+void uartPinChange() {
+#  else
 /* Interrupt handler for the pin change
  */
 ISR(PCINT0_vect) {
+  LATENCY_ISR();
+#  endif
   uint8_t ch;
   // Make sure it is our pin and it is 0
   if(!(PINB&(1<<UART_RX))) {
@@ -138,14 +146,29 @@ ISR(PCINT0_vect) {
       : "=r" (ch)
       : [uart_port] "I" (_SFR_IO_ADDR(PORTB)),
         [uart_pin] "I" (UART_RX),
-        [rxdelay] "I" (RXDELAY),
-        [rxdelay2] "I" (RXDELAY2)
+        [rxdelay] "M" (RXDELAY),
+        [rxdelay2] "M" (RXDELAY2)
       : "r0","r18","r19");
+#ifdef BUS_ENABLED
+    // Only keep frames addressed to us (the zero that ends the frame is kept
+    // so the packet decoder sees the end of it)
+    if(ch==0) {
+      bool accept = (g_busState==BUS_ACCEPT);
+      g_busState = BUS_ADDRESS;
+      if(!accept)
+        return;
+      }
+    else if(g_busState==BUS_ADDRESS) {
+      g_busState = ((ch==g_busAddress)||(ch==BUS_BROADCAST))?BUS_ACCEPT:BUS_IGNORE;
+      return;
+      }
+    else if(g_busState!=BUS_ACCEPT)
+      return;
+#endif
     // Now put it in the buffer (if we have room)
     if(g_index<UART_BUFFER)
       g_buffer[g_index++] = ch;
     }
-  // TODO: Chain on to the user interrupt handler if available.
   }
 #endif /* UART_INTERRUPT */
 
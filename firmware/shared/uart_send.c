@@ -21,6 +21,7 @@
 #include "../hardware.h"
 #include "uart_defs.h"
 #include "softuart.h"
+#include "latency.h"
 
 // Only if enabled
 #ifdef UART_ENABLED
@@ -35,12 +36,12 @@ void uartInit() {
   // Set up TX pin
   DDRB |= (1 << UART_TX);
   PORTB |= (1 << UART_TX);
-#  ifdef UART_INTERRUPT
+#endif /* UART_TWOPIN */
+#ifdef UART_INTERRUPT
   // Enable pin change interrupts
   PCMSK |= (1 << UART_RX);
   GIMSK |= (1 << PCIE);
-#  endif /* UART_INTERRUPT */
-#endif /* UART_TWOPIN */
+#endif /* UART_INTERRUPT */
   }
 
 /** Write a single character
@@ -49,20 +50,79 @@ void uartInit() {
  *
  * @param ch the character to send.
  */
+#ifdef BUS_ENABLED
+void uartSend(char ch) {
+  // Nothing more is sent once a collision has been seen
+  if(g_busCollision)
+    return;
+  // Start bit, data bits (LSB first) and stop bit, sent from bit 0
+  uint16_t frame = ((uint16_t)(uint8_t)ch << 1) | 0xFE00;
+  uint8_t collided, count, delay;
+  // Open drain - the pin is driven low or released, never driven high
+  PORTB &= ~(1 << UART_TX);
+  LATENCY_CLI();
+  asm volatile(
+    "  clr %[collided]                  \n\t"
+    "  ldi %[count], 10                 \n\t"
+    "BusLoop:                           \n\t"
+    // 12 cycle loop + delays - total = 12 + 3*(BUSDELAY1 + BUSDELAY2)
+    "  lsr %B[frame]                    \n\t"
+    "  ror %A[frame]                    \n\t"
+    "  brcs BusOne                      \n\t"
+    "  sbi %[uart_ddr], %[uart_pin]     \n\t" // drive low for a 0
+    "  rjmp BusWait                     \n\t"
+    "BusOne:                            \n\t"
+    "  cbi %[uart_ddr], %[uart_pin]     \n\t" // release for a 1
+    "  nop                              \n\t"
+    "BusWait:                           \n\t"
+    "  ldi %[delay], %[busdelay1]       \n\t"
+    "BusDelay1:                         \n\t"
+    "  dec %[delay]                     \n\t"
+    "  brne BusDelay1                   \n\t"
+    // If the line is low when we released it someone else is sending
+    "  sbis %[uart_ddr]-1, %[uart_pin]  \n\t"
+    "  brcs BusCollision                \n\t"
+    "  ldi %[delay], %[busdelay2]       \n\t"
+    "BusDelay2:                         \n\t"
+    "  dec %[delay]                     \n\t"
+    "  brne BusDelay2                   \n\t"
+    "  dec %[count]                     \n\t"
+    "  brne BusLoop                     \n\t"
+    "  rjmp BusDone                     \n\t"
+    "BusCollision:                      \n\t"
+    "  inc %[collided]                  \n\t"
+    "BusDone:                           \n\t"
+    : [collided] "=&r" (collided),
+      [count] "=&d" (count),
+      [delay] "=&d" (delay),
+      [frame] "+r" (frame)
+    : [uart_ddr] "I" (_SFR_IO_ADDR(DDRB)),
+      [uart_pin] "I" (UART_TX),
+      [busdelay1] "M" (BUSDELAY1),
+      [busdelay2] "M" (BUSDELAY2)
+    );
+  LATENCY_SEI();
+  if(collided) {
+    // Back off and ignore the rest of the frame we interrupted
+    g_busCollision = true;
+    g_busState = BUS_IGNORE;
+    }
+  }
+#else
 void uartSend(char ch) {
   // Set to output state and bring high
   PORTB |= (1 << UART_TX);
 #ifdef UART_ONEPIN
   DDRB  |= (1 << UART_TX);
 #endif
-  cli();
+  LATENCY_CLI();
   asm volatile(
     "  cbi %[uart_port], %[uart_pin]    \n\t"  // start bit
     "  in r0, %[uart_port]              \n\t"
     "  ldi r30, 3                       \n\t"  // stop bit + idle state
     "  ldi r28, %[txdelay]              \n\t"
     "TxLoop:                            \n\t"
-    // 8 cycle loop + delay - total = 7 + 3*r22
+    // 8 cycle loop + delay - total = 7 + 3*r22 + padding
     "  mov r29, r28                     \n\t"
     "TxDelay:                           \n\t"
     // delay (3 cycle * delayCount) - 1
@@ -73,20 +133,25 @@ void uartSend(char ch) {
     "  lsr r30                          \n\t"
     "  ror %[ch]                        \n\t"
     "  out %[uart_port], r0             \n\t"
+    "  .rept %[txpad]                   \n\t"  // round to the exact bit time
+    "  nop                              \n\t"
+    "  .endr                            \n\t"
     "  brne TxLoop                      \n\t"
     :
     : [uart_port] "I" (_SFR_IO_ADDR(PORTB)),
       [uart_pin] "I" (UART_TX),
-      [txdelay] "I" (TXDELAY),
+      [txdelay] "M" (TXDELAY),
+      [txpad] "M" (TXPAD),
       [ch] "r" (ch)
     : "r0","r28","r29","r30");
-  sei();
+  LATENCY_SEI();
 #ifdef UART_ONEPIN
   // Change back to idle state
   DDRB  &= ~(1 << UART_TX);
   PORTB &= ~(1 << UART_TX);
 #endif
   }
+#endif /* BUS_ENABLED */
 
 #endif /* UART_ENABLED */
 
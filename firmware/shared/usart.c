@@ -0,0 +1,179 @@
+/*--------------------------------------------------------------------------*
+* Hardware USART implementation for ATmega
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Provides the same core API as the software UART (see softuart.h) using
+* the hardware USART on the ATmega8, ATmega88 and ATmega168. Transmit and
+* receive are both interrupt driven through ring buffers so uartSend() only
+* waits when the transmit buffer is full. The formatted output functions in
+* uart_print.c and uart_format.c work unchanged on top of this.
+*
+* The USART runs in double speed mode so any baud rate that divides F_CPU/8
+* exactly has no timing error (up to 1000000 baud at 8MHz or 16MHz). Rates
+* that would be more than 2% out are rejected at compile time (57600 baud
+* is 2.1% out at 8MHz, 38400 is 0.2%).
+*--------------------------------------------------------------------------*/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "../hardware.h"
+#include "softuart.h"
+#include "latency.h"
+
+// Only if enabled
+#ifdef UART_ENABLED
+
+//--- Register names (the ATmega88/168 number the USART)
+#ifdef UDR0
+#  define USART_UBRRH  UBRR0H
+#  define USART_UBRRL  UBRR0L
+#  define USART_UCSRA  UCSR0A
+#  define USART_UCSRB  UCSR0B
+#  define USART_UCSRC  UCSR0C
+#  define USART_UDR    UDR0
+#  define USART_U2X    U2X0
+#  define USART_RXCIE  RXCIE0
+#  define USART_UDRIE  UDRIE0
+#  define USART_RXEN   RXEN0
+#  define USART_TXEN   TXEN0
+#  define USART_UDRE   UDRE0
+#  define USART_FORMAT ((1 << UCSZ01) | (1 << UCSZ00))
+#  define USART_RECV_vect USART_RX_vect
+#else
+#  define USART_UBRRH  UBRRH
+#  define USART_UBRRL  UBRRL
+#  define USART_UCSRA  UCSRA
+#  define USART_UCSRB  UCSRB
+#  define USART_UCSRC  UCSRC
+#  define USART_UDR    UDR
+#  define USART_U2X    U2X
+#  define USART_RXCIE  RXCIE
+#  define USART_UDRIE  UDRIE
+#  define USART_RXEN   RXEN
+#  define USART_TXEN   TXEN
+#  define USART_UDRE   UDRE
+#  define USART_FORMAT ((1 << URSEL) | (1 << UCSZ1) | (1 << UCSZ0))
+#  define USART_RECV_vect USART_RXC_vect
+#endif
+
+// Baud rate divider for double speed mode (rounded to nearest)
+#define USART_DIVIDER (((F_CPU + (4UL * BAUD_RATE)) / (8UL * BAUD_RATE)) - 1)
+
+// The baud rate the divider actually gives
+#define USART_ACTUAL (F_CPU / (8UL * (USART_DIVIDER + 1)))
+
+// Sanity checks
+#if (UART_BUFFER & (UART_BUFFER - 1)) || (UART_BUFFER > 256)
+#  error "UART_BUFFER must be a power of two (max 256) for the USART"
+#endif
+#if (UART_TX_BUFFER & (UART_TX_BUFFER - 1)) || (UART_TX_BUFFER > 256)
+#  error "UART_TX_BUFFER must be a power of two (max 256)"
+#endif
+#if USART_DIVIDER > 4095
+#  error low baud rates unsupported - use higher BAUD_RATE
+#endif
+#if ((USART_ACTUAL * 50UL) > (BAUD_RATE * 51UL)) || ((USART_ACTUAL * 50UL) < (BAUD_RATE * 49UL))
+#  error BAUD_RATE is more than 2% out at this F_CPU - use a rate closer to a divisor of F_CPU/8
+#endif
+
+//! Receive buffer
+static uint8_t g_rxBuffer[UART_BUFFER];
+
+//! Receive buffer indices (written by the ISR and uartRecv() respectively)
+static volatile uint8_t g_rxHead = 0, g_rxTail = 0;
+
+//! Transmit buffer
+static uint8_t g_txBuffer[UART_TX_BUFFER];
+
+//! Transmit buffer indices (written by uartSend() and the ISR respectively)
+static volatile uint8_t g_txHead = 0, g_txTail = 0;
+
+/** Initialise the UART
+ */
+void uartInit() {
+  USART_UBRRH = (uint8_t)(USART_DIVIDER >> 8);
+  USART_UBRRL = (uint8_t)USART_DIVIDER;
+  USART_UCSRA = (1 << USART_U2X);
+  USART_UCSRC = USART_FORMAT;
+  USART_UCSRB = (1 << USART_RXCIE) | (1 << USART_RXEN) | (1 << USART_TXEN);
+  }
+
+/** Write a single character
+ *
+ * Adds the character to the transmit buffer, waiting for room if the buffer
+ * is full. If interrupts are disabled the buffer is emptied directly
+ * instead of waiting for the interrupt.
+ *
+ * @param ch the character to send.
+ */
+void uartSend(char ch) {
+  uint8_t next = (g_txHead + 1) & (UART_TX_BUFFER - 1);
+  while(next==g_txTail) {
+    // Nothing will empty the buffer if interrupts are off
+    if(!(SREG & (1 << SREG_I)) && (USART_UCSRA & (1 << USART_UDRE))) {
+      USART_UDR = g_txBuffer[g_txTail];
+      g_txTail = (g_txTail + 1) & (UART_TX_BUFFER - 1);
+      }
+    }
+  g_txBuffer[g_txHead] = ch;
+  g_txHead = next;
+  // Make sure the transmitter is running
+  USART_UCSRB |= (1 << USART_UDRIE);
+  }
+
+/** Determine if characters are available
+ *
+ * Check the number of characters available for immediate reading. If this
+ * function returns a non-zero value the next call to uartRecv() will be
+ * guaranteed to return immediately with a value.
+ *
+ * @return the number of characters available in the input buffer.
+ */
+uint8_t uartAvail() {
+  return (g_rxHead - g_rxTail) & (UART_BUFFER - 1);
+  }
+
+/** Receive a single character
+ *
+ * Wait for a single character on the UART and return it.
+ *
+ * @return the character received.
+ */
+char uartRecv() {
+  // Wait for a character
+  while(g_rxHead==g_rxTail);
+  char ch = g_rxBuffer[g_rxTail];
+  g_rxTail = (g_rxTail + 1) & (UART_BUFFER - 1);
+  return ch;
+  }
+
+/** Receive complete interrupt
+ *
+ * Characters that arrive when the buffer is full are dropped.
+ */
+ISR(USART_RECV_vect) {
+  LATENCY_ISR();
+  uint8_t ch = USART_UDR;
+  uint8_t next = (g_rxHead + 1) & (UART_BUFFER - 1);
+  if(next!=g_rxTail) {
+    g_rxBuffer[g_rxHead] = ch;
+    g_rxHead = next;
+    }
+  }
+
+/** Data register empty interrupt
+ *
+ * Sends the next character from the transmit buffer and disables itself
+ * when the buffer is empty.
+ */
+ISR(USART_UDRE_vect) {
+  LATENCY_ISR();
+  if(g_txHead==g_txTail) {
+    USART_UCSRB &= ~(1 << USART_UDRIE);
+    return;
+    }
+  USART_UDR = g_txBuffer[g_txTail];
+  g_txTail = (g_txTail + 1) & (UART_TX_BUFFER - 1);
+  }
+
+#endif /* UART_ENABLED */
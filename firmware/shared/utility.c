@@ -5,27 +5,65 @@
 *
 * A collection of utility functions that don't really fit anywhere else.
 *--------------------------------------------------------------------------*/
+#include <avr/io.h>
+#include <avr/interrupt.h>
 #include "utility.h"
+#include "latency.h"
 
-// Determine the inner loop for the 'wait()' function. This is based on 6
-// instruction cycles per loop.
-#define WAIT_INNER (F_CPU / 6000)
+// Clock source selected by the fuses for the clock profile
+#if F_CPU > 8000000
+#  define CLOCK_SOURCE 16000000UL
+#else
+#  define CLOCK_SOURCE 8000000UL
+#endif
 
-/** An inaccurate delay function
+// Prescaler (CLKPS) value to get F_CPU from the clock source
+#if (CLOCK_SOURCE / F_CPU) == 1
+#  define CLOCK_PRESCALE 0
+#elif (CLOCK_SOURCE / F_CPU) == 2
+#  define CLOCK_PRESCALE 1
+#elif (CLOCK_SOURCE / F_CPU) == 4
+#  define CLOCK_PRESCALE 2
+#elif (CLOCK_SOURCE / F_CPU) == 8
+#  define CLOCK_PRESCALE 3
+#elif (CLOCK_SOURCE / F_CPU) == 16
+#  define CLOCK_PRESCALE 4
+#else
+#  error "F_CPU must be the clock source divided by a power of two"
+#endif
+
+// Number of cycles per millisecond for the 'wait()' function. The loop
+// itself takes 4 cycles per iteration so we take that off the delay.
+#define WAIT_CYCLES ((F_CPU / 1000) - 4)
+
+/** Set the clock prescaler for F_CPU
+ *
+ * The clock source is chosen by the fuses - the 8MHz internal oscillator or
+ * the 16MHz PLL (a 16MHz crystal on the ATmega parts) when F_CPU is above
+ * 8MHz. This sets the prescaler so the CPU runs at F_CPU regardless of the
+ * CKDIV8 fuse. Call this before any other initialisation. The ATmega8 has
+ * no prescaler so this does nothing there, the fuses alone set the clock.
+ */
+void clockInit() {
+#ifdef CLKPR
+  LATENCY_SAVE(sreg);
+  // The new value must be written within 4 cycles of setting CLKPCE
+  CLKPR = (1 << CLKPCE);
+  CLKPR = CLOCK_PRESCALE;
+  LATENCY_RESTORE(sreg);
+#endif
+  }
+
+/** A simple delay function
  *
- * This function will delay for the given number of milliseconds. This is not
- * an accurate delay (interrupt activity will interfere with the timing and it
- * uses instruction timing approximations to consume the time) but should be
- * close enough for many purposes without having to revert to a timer interrupt.
+ * This function will delay for the given number of milliseconds. Each
+ * millisecond is timed exactly but interrupt activity will extend the delay
+ * and the CPU is kept busy the whole time. For longer delays consider using
+ * sleepMs() instead.
  */
 void wait(uint16_t millis) {
-  for(uint16_t outer=0; outer<millis; outer++) {
-    for(uint16_t inner=0; inner<WAIT_INNER; inner++) {
-      asm volatile(
-        "  nop    \n\t"
-        );
-      }
-    }
+  for(; millis>0; millis--)
+    delayCycles(WAIT_CYCLES);
   }
 
 /** Convert the low four bits of a byte value into an upper case hex digit.
@@ -0,0 +1,199 @@
+/*--------------------------------------------------------------------------*
+* WS2812 / SK6812 LED strip driver implementation
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* The output loop sends one byte per iteration with every cycle accounted
+* for. Each bit has three gaps where other work can be done:
+*
+*   A - 1 cycle between the rising edge and testing the bit
+*   B - 2 cycles while the high period of a 1 bit is stretched
+*   C - 3 cycles after the falling edge
+*
+* At 16MHz the gaps are padded out to 4, 5 and 7 cycles. The gaps are used
+* to fetch the byte after the one being sent and, if required, scale it by
+* the brightness. Scaling is a shift and add multiply using the pre-shifted
+* value ((value / 2) * brightness / 128) so no carry needs to be kept.
+*--------------------------------------------------------------------------*/
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <avr/interrupt.h>
+#include <stdbool.h>
+#include "../hardware.h"
+#include "latency.h"
+#include "ws2812.h"
+
+// Only if enabled
+#ifdef WS2812_ENABLED
+
+//--- Padding to stretch the gaps for the clock speed
+#if F_CPU == 8000000
+#  define WS2812_PAD_A ""
+#  define WS2812_PAD_B ""
+#  define WS2812_PAD_C ""
+#elif F_CPU == 16000000
+#  define WS2812_PAD_A "  rjmp .+0                \n\t  nop \n\t"
+#  define WS2812_PAD_B "  rjmp .+0                \n\t  nop \n\t"
+#  define WS2812_PAD_C "  rjmp .+0                \n\t  rjmp .+0 \n\t"
+#else
+#  error "The WS2812 driver requires an 8MHz or 16MHz clock"
+#endif
+
+/** Send a single bit
+ *
+ * The line goes high, drops after 3 cycles for a 0 or 6 cycles for a 1 and
+ * the bit ends 10 cycles after it started (twice that at 16MHz). The code
+ * in 'a', 'b' and 'c' must take exactly 1, 2 and 3 cycles.
+ */
+#define WS2812_BIT(n, a, b, c) \
+  "  out %[port], %[hi]       \n\t" WS2812_PAD_A a \
+  "  sbrs %[out], " #n "      \n\t" \
+  "  out %[port], %[lo]       \n\t" WS2812_PAD_B b \
+  "  out %[port], %[lo]       \n\t" WS2812_PAD_C c
+
+//--- Fetch the next byte (3 cycles)
+#define WS2812_LOAD_RAM   "  ld %[next], %a[ptr]+     \n\t  nop \n\t"
+#define WS2812_LOAD_FLASH "  lpm %[next], %a[ptr]+    \n\t"
+
+//--- Helpers for the gaps
+#define WS2812_NOP1 "  nop                      \n\t"
+#define WS2812_NOP2 "  rjmp .+0                 \n\t"
+#define WS2812_NOP3 WS2812_NOP2 WS2812_NOP1
+#define WS2812_ADD(n) "  sbrc %[scale], " #n "    \n\t  add %[acc], %[next] \n\t"
+#define WS2812_SHIFT  "  lsr %[acc]               \n\t"
+
+/** Output loop with no scaling
+ *
+ * 'next' holds the byte to send when the loop starts.
+ */
+#define WS2812_LOOP(load) \
+  "1:                         \n\t" \
+  WS2812_BIT(7, "  mov %[out], %[next]      \n\t", WS2812_NOP2, load) \
+  WS2812_BIT(6, WS2812_NOP1, "  sbiw %[count], 1         \n\t", WS2812_NOP3) \
+  WS2812_BIT(5, WS2812_NOP1, WS2812_NOP2, WS2812_NOP3) \
+  WS2812_BIT(4, WS2812_NOP1, WS2812_NOP2, WS2812_NOP3) \
+  WS2812_BIT(3, WS2812_NOP1, WS2812_NOP2, WS2812_NOP3) \
+  WS2812_BIT(2, WS2812_NOP1, WS2812_NOP2, WS2812_NOP3) \
+  WS2812_BIT(1, WS2812_NOP1, WS2812_NOP2, WS2812_NOP3) \
+  WS2812_BIT(0, WS2812_NOP1, WS2812_NOP2, WS2812_NOP1 "  brne 1b                  \n\t")
+
+/** Output loop with scaling
+ *
+ * 'acc' holds the scaled byte to send and 'next' holds the following byte
+ * shifted right by one when the loop starts.
+ */
+#define WS2812_LOOP_SCALED(load) \
+  "1:                         \n\t" \
+  WS2812_BIT(7, "  mov %[out], %[acc]       \n\t", "  clr %[acc] \n\t" WS2812_NOP1, WS2812_ADD(0) WS2812_SHIFT) \
+  WS2812_BIT(6, WS2812_NOP1, WS2812_ADD(1), WS2812_SHIFT WS2812_ADD(2)) \
+  WS2812_BIT(5, WS2812_SHIFT, WS2812_ADD(3), WS2812_SHIFT WS2812_ADD(4)) \
+  WS2812_BIT(4, WS2812_SHIFT, WS2812_ADD(5), WS2812_SHIFT WS2812_ADD(6)) \
+  WS2812_BIT(3, WS2812_SHIFT, WS2812_ADD(7), load) \
+  WS2812_BIT(2, "  lsr %[next]              \n\t", "  sbiw %[count], 1         \n\t", WS2812_NOP3) \
+  WS2812_BIT(1, WS2812_NOP1, WS2812_NOP2, WS2812_NOP3) \
+  WS2812_BIT(0, WS2812_NOP1, WS2812_NOP2, WS2812_NOP1 "  brne 1b                  \n\t")
+
+//--- The output statement for a loop and pointer register
+#define WS2812_OUTPUT(loop, pointer) \
+  asm volatile( \
+    loop \
+    : [out] "=&r" (out), \
+      [acc] "+r" (acc), \
+      [next] "+r" (next), \
+      [ptr] pointer (ptr), \
+      [count] "+w" (length) \
+    : [port] "I" (_SFR_IO_ADDR(PORTB)), \
+      [hi] "r" (hi), \
+      [lo] "r" (lo), \
+      [scale] "r" (brightness))
+
+/** Scale a single byte
+ *
+ * Uses the same steps as the output loop so the first byte matches the
+ * rest.
+ *
+ * @param value the value to scale.
+ * @param brightness the scale to apply.
+ *
+ * @return the scaled value.
+ */
+static uint8_t ws2812Scale(uint8_t value, uint8_t brightness) {
+  uint8_t result = 0;
+  value >>= 1;
+  for(uint8_t bit=0; bit<8; bit++) {
+    if(bit)
+      result >>= 1;
+    if(brightness & (1 << bit))
+      result += value;
+    }
+  return result;
+  }
+
+/** Send colour data from RAM or PROGMEM
+ *
+ * The loop always reads ahead of the byte being sent, the extra bytes read
+ * past the end of the data are never sent.
+ *
+ * @param pData pointer to the GRB data.
+ * @param length the number of bytes to send.
+ * @param brightness scale applied to each byte (255 for full brightness).
+ * @param flash true if the data is in PROGMEM.
+ */
+static void ws2812Write(const uint8_t *pData, uint16_t length, uint8_t brightness, bool flash) {
+  uint8_t out, acc = 0, next, hi, lo;
+  const uint8_t *ptr = pData;
+  if(length==0)
+    return;
+  LATENCY_CLI();
+  hi = PORTB | (1 << WS2812_PIN);
+  lo = PORTB & ~(1 << WS2812_PIN);
+  if(brightness==255) {
+    next = flash?pgm_read_byte(ptr):*ptr;
+    ptr++;
+    if(flash)
+      WS2812_OUTPUT(WS2812_LOOP(WS2812_LOAD_FLASH), "+z");
+    else
+      WS2812_OUTPUT(WS2812_LOOP(WS2812_LOAD_RAM), "+x");
+    }
+  else {
+    acc = ws2812Scale(flash?pgm_read_byte(ptr):*ptr, brightness);
+    next = (flash?pgm_read_byte(ptr + 1):ptr[1]) >> 1;
+    ptr += 2;
+    if(flash)
+      WS2812_OUTPUT(WS2812_LOOP_SCALED(WS2812_LOAD_FLASH), "+z");
+    else
+      WS2812_OUTPUT(WS2812_LOOP_SCALED(WS2812_LOAD_RAM), "+x");
+    }
+  LATENCY_SEI();
+  }
+
+/** Initialise the LED strip pin
+ *
+ * Sets the data pin as an output and drives it low.
+ */
+void ws2812Init() {
+  PORTB &= ~(1 << WS2812_PIN);
+  DDRB |= (1 << WS2812_PIN);
+  }
+
+/** Send colour data from RAM
+ *
+ * @param pData pointer to the GRB data (3 bytes per LED).
+ * @param length the number of bytes to send.
+ * @param brightness scale applied to each byte (255 for full brightness).
+ */
+void ws2812Send(const uint8_t *pData, uint16_t length, uint8_t brightness) {
+  ws2812Write(pData, length, brightness, false);
+  }
+
+/** Send colour data from PROGMEM
+ *
+ * @param pData pointer to the GRB data (3 bytes per LED) in PROGMEM.
+ * @param length the number of bytes to send.
+ * @param brightness scale applied to each byte (255 for full brightness).
+ */
+void ws2812SendP(const uint8_t *pData, uint16_t length, uint8_t brightness) {
+  ws2812Write(pData, length, brightness, true);
+  }
+
+#endif /* WS2812_ENABLED */
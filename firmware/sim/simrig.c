@@ -0,0 +1,491 @@
+/*--------------------------------------------------------------------------*
+* Virtual test rig for simavr
+*---------------------------------------------------------------------------*
+* 19-Oct-2026 ShaneG
+*
+* Runs firmware under simavr with a virtual serial port and a virtual Nokia
+* (PCD8544) LCD attached so the firmware and the host tools can be tested
+* together without any hardware.
+*
+* The soft UART pins are connected to a pseudo terminal, the name of the
+* slave side is printed on startup (and optionally linked to a fixed name)
+* so tools like microboot.py can be pointed at it. The LCD pins are decoded
+* into an 84x48 frame buffer which is written as a PNG image when the
+* simulation ends or when the process receives SIGUSR1.
+*
+* Usage: simrig [options] firmware.elf
+*   -m mcu       MCU to simulate (default attiny85)
+*   -f freq      Clock frequency (default 8000000)
+*   -b baud      UART baud rate (default 57600)
+*   -t pin       UART TX pin (default 5)
+*   -r pin       UART RX pin (default 5)
+*   -L s,m,c,r   LCD SCK, MOSI, CD and RESET pins (default 4,2,1,0)
+*   -o file      PNG file for the LCD contents (default lcd.png)
+*   -s scale     Size of each LCD pixel in the image (default 4)
+*   -p link      Create a symbolic link to the pty with this name
+*
+* The defaults match the pin assignments in hardware.h. The AVR register
+* addresses used are those of the ATtiny25/45/85.
+*--------------------------------------------------------------------------*/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sim_avr.h>
+#include <sim_elf.h>
+#include <sim_irq.h>
+#include <sim_io.h>
+#include <sim_cycle_timers.h>
+#include <avr_ioport.h>
+
+// Data space address of DDRB
+#define DDRB_ADDR 0x37
+
+// LCD geometry
+#define LCD_COL 84
+#define LCD_ROW 6
+
+// How often (in instructions) to poll the pty for input
+#define POLL_INTERVAL 1000
+
+//---------------------------------------------------------------------------
+// Configuration
+//---------------------------------------------------------------------------
+
+static const char *g_mcu = "attiny85";
+static uint32_t g_frequency = 8000000;
+static uint32_t g_baud = 57600;
+static int g_txPin = 5;
+static int g_rxPin = 5;
+static int g_lcdSck = 4, g_lcdMosi = 2, g_lcdCd = 1, g_lcdReset = 0;
+static const char *g_image = "lcd.png";
+static int g_scale = 4;
+static const char *g_link = NULL;
+
+//---------------------------------------------------------------------------
+// Shared state
+//---------------------------------------------------------------------------
+
+//! The simulated processor
+static avr_t *g_avr;
+
+//! IRQs for each pin on port B
+static avr_irq_t *g_pins[8];
+
+//! Last level seen on each pin
+static uint8_t g_levels[8];
+
+//! Master side of the pty
+static int g_pty = -1;
+
+//! Set by the signal handlers
+static volatile sig_atomic_t g_dump = 0;
+static volatile sig_atomic_t g_quit = 0;
+
+//---------------------------------------------------------------------------
+// UART
+//---------------------------------------------------------------------------
+
+//! Cycles per bit
+static avr_cycle_count_t g_bitTime;
+
+//! Transmit (AVR to host) decoder state
+static bool g_txBusy = false;
+static uint8_t g_txBits, g_txData;
+
+//! Receive (host to AVR) encoder state
+static bool g_rxBusy = false;
+static uint16_t g_rxFrame;
+static uint8_t g_rxBits;
+
+/** Sample the next bit sent by the AVR
+ */
+static avr_cycle_count_t txSample(avr_t *avr, avr_cycle_count_t when, void *param) {
+  if(g_txBits<8) {
+    g_txData = (g_txData >> 1) | (g_levels[g_txPin]?0x80:0x00);
+    g_txBits++;
+    return when + g_bitTime;
+    }
+  // Stop bit, pass the character on if it is valid
+  if(g_levels[g_txPin]&&(g_pty>=0)) {
+    if(write(g_pty, &g_txData, 1)!=1)
+      fprintf(stderr, "WARNING: Unable to write to pty\n");
+    }
+  g_txBusy = false;
+  return 0;
+  }
+
+/** Drive the next bit sent to the AVR
+ */
+static avr_cycle_count_t rxDrive(avr_t *avr, avr_cycle_count_t when, void *param) {
+  if(g_rxBits==10) {
+    g_rxBusy = false;
+    return 0;
+    }
+  avr_raise_irq(g_pins[g_rxPin], (g_rxFrame >> g_rxBits) & 0x01);
+  g_rxBits++;
+  return when + g_bitTime;
+  }
+
+/** Start sending a character to the AVR
+ */
+static void rxStart(uint8_t ch) {
+  // Start bit, 8 data bits (LSB first) and a stop bit
+  g_rxFrame = ((uint16_t)ch << 1) | 0x200;
+  g_rxBits = 0;
+  g_rxBusy = true;
+  avr_cycle_timer_register(g_avr, 1, rxDrive, NULL);
+  }
+
+/** Check the pty for data to send to the AVR
+ */
+static void rxPoll() {
+  uint8_t ch;
+  if(g_rxBusy||g_txBusy||(g_pty<0))
+    return;
+  if(read(g_pty, &ch, 1)==1)
+    rxStart(ch);
+  }
+
+/** Open the pty and put it in raw mode
+ */
+static bool ptyOpen() {
+  g_pty = posix_openpt(O_RDWR | O_NOCTTY);
+  if((g_pty<0)||(grantpt(g_pty)!=0)||(unlockpt(g_pty)!=0))
+    return false;
+  struct termios tio;
+  tcgetattr(g_pty, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(g_pty, TCSANOW, &tio);
+  fcntl(g_pty, F_SETFL, fcntl(g_pty, F_GETFL) | O_NONBLOCK);
+  const char *name = ptsname(g_pty);
+  printf("UART connected to %s\n", name);
+  if(g_link!=NULL) {
+    unlink(g_link);
+    if(symlink(name, g_link)!=0)
+      fprintf(stderr, "WARNING: Unable to create link '%s'\n", g_link);
+    else
+      printf("UART linked to %s\n", g_link);
+    }
+  fflush(stdout);
+  return true;
+  }
+
+//---------------------------------------------------------------------------
+// PCD8544 LCD
+//---------------------------------------------------------------------------
+
+//! Display memory
+static uint8_t g_lcd[LCD_ROW][LCD_COL];
+
+//! Controller state
+static uint8_t g_lcdX, g_lcdY;
+static bool g_lcdExtended, g_lcdVertical, g_lcdPowerDown;
+static uint8_t g_lcdMode; // D and E bits of the display control command
+static uint8_t g_lcdBits, g_lcdShift;
+
+/** Reset the controller
+ */
+static void lcdReset() {
+  memset(g_lcd, 0, sizeof(g_lcd));
+  g_lcdX = g_lcdY = 0;
+  g_lcdExtended = g_lcdVertical = false;
+  g_lcdPowerDown = true;
+  g_lcdMode = 0;
+  g_lcdBits = 0;
+  }
+
+/** Process a command byte
+ */
+static void lcdCommand(uint8_t cmd) {
+  if((cmd & 0xF8)==0x20) {
+    // Function set (valid in both instruction sets)
+    g_lcdPowerDown = cmd & 0x04;
+    g_lcdVertical = cmd & 0x02;
+    g_lcdExtended = cmd & 0x01;
+    }
+  else if(g_lcdExtended) {
+    // Contrast, bias and temperature settings are ignored
+    }
+  else if(cmd & 0x80)
+    g_lcdX = (cmd & 0x7F) % LCD_COL;
+  else if(cmd & 0x40)
+    g_lcdY = (cmd & 0x07) % LCD_ROW;
+  else if((cmd & 0xF8)==0x08)
+    g_lcdMode = ((cmd >> 1) & 0x02) | (cmd & 0x01);
+  }
+
+/** Process a data byte
+ */
+static void lcdData(uint8_t data) {
+  g_lcd[g_lcdY][g_lcdX] = data;
+  if(g_lcdVertical) {
+    if(++g_lcdY==LCD_ROW) {
+      g_lcdY = 0;
+      g_lcdX = (g_lcdX + 1) % LCD_COL;
+      }
+    }
+  else if(++g_lcdX==LCD_COL) {
+    g_lcdX = 0;
+    g_lcdY = (g_lcdY + 1) % LCD_ROW;
+    }
+  }
+
+/** Determine if a pixel is dark
+ */
+static bool lcdPixel(int x, int y) {
+  if(g_lcdPowerDown)
+    return false;
+  switch(g_lcdMode) {
+    case 0: return false; // Blank
+    case 1: return true;  // All segments on
+    case 3: return !(g_lcd[y / 8][x] & (1 << (y % 8))); // Inverse
+    }
+  return g_lcd[y / 8][x] & (1 << (y % 8));
+  }
+
+//---------------------------------------------------------------------------
+// PNG output (uncompressed deflate, no external libraries needed)
+//---------------------------------------------------------------------------
+
+static uint32_t g_crcTable[256];
+
+/** Calculate the CRC32 of a block of data
+ */
+static uint32_t crc32(uint32_t crc, const uint8_t *data, size_t length) {
+  if(g_crcTable[1]==0) {
+    for(uint32_t n=0; n<256; n++) {
+      uint32_t c = n;
+      for(int k=0; k<8; k++)
+        c = (c & 1)?(0xEDB88320 ^ (c >> 1)):(c >> 1);
+      g_crcTable[n] = c;
+      }
+    }
+  crc = ~crc;
+  while(length--)
+    crc = g_crcTable[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+  }
+
+/** Write a 32 bit big endian value to a buffer
+ */
+static uint8_t *putLong(uint8_t *buffer, uint32_t value) {
+  buffer[0] = value >> 24;
+  buffer[1] = value >> 16;
+  buffer[2] = value >> 8;
+  buffer[3] = value;
+  return buffer + 4;
+  }
+
+/** Write a PNG chunk
+ */
+static void pngChunk(FILE *fp, const char *type, const uint8_t *data, uint32_t length) {
+  uint8_t header[8];
+  putLong(header, length);
+  memcpy(header + 4, type, 4);
+  uint32_t crc = crc32(crc32(0, header + 4, 4), data, length);
+  fwrite(header, 1, 8, fp);
+  fwrite(data, 1, length, fp);
+  putLong(header, crc);
+  fwrite(header, 1, 4, fp);
+  }
+
+/** Write the LCD contents to a PNG file
+ */
+static void lcdSave(const char *filename) {
+  uint32_t width = LCD_COL * g_scale, height = LCD_ROW * 8 * g_scale;
+  // Build the raw image (filter byte + 8 bit greyscale per line)
+  size_t rawLength = (width + 1) * height;
+  uint8_t *raw = malloc(rawLength);
+  uint8_t *line = raw;
+  for(uint32_t y=0; y<height; y++) {
+    *line++ = 0;
+    for(uint32_t x=0; x<width; x++)
+      *line++ = lcdPixel(x / g_scale, y / g_scale)?0x20:0xC0;
+    }
+  // Wrap it in a zlib stream using stored blocks
+  size_t blocks = (rawLength + 65534) / 65535;
+  uint8_t *zdata = malloc(rawLength + (blocks * 5) + 6);
+  uint8_t *out = zdata;
+  *out++ = 0x78;
+  *out++ = 0x01;
+  uint32_t a = 1, b = 0;
+  for(size_t offset=0; offset<rawLength; ) {
+    uint16_t size = ((rawLength - offset)>65535)?65535:(rawLength - offset);
+    *out++ = ((offset + size)==rawLength)?1:0;
+    *out++ = size & 0xFF;
+    *out++ = size >> 8;
+    *out++ = ~size & 0xFF;
+    *out++ = ~size >> 8;
+    memcpy(out, raw + offset, size);
+    for(uint16_t index=0; index<size; index++) {
+      a = (a + out[index]) % 65521;
+      b = (b + a) % 65521;
+      }
+    out += size;
+    offset += size;
+    }
+  out = putLong(out, (b << 16) | a);
+  // Write the file
+  FILE *fp = fopen(filename, "wb");
+  if(fp==NULL) {
+    fprintf(stderr, "WARNING: Unable to create '%s'\n", filename);
+    free(raw);
+    free(zdata);
+    return;
+    }
+  static const uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+  fwrite(signature, 1, sizeof(signature), fp);
+  uint8_t ihdr[13];
+  putLong(putLong(ihdr, width), height);
+  ihdr[8] = 8;   // Bit depth
+  ihdr[9] = 0;   // Greyscale
+  ihdr[10] = 0;  // Compression
+  ihdr[11] = 0;  // Filter
+  ihdr[12] = 0;  // No interlace
+  pngChunk(fp, "IHDR", ihdr, sizeof(ihdr));
+  pngChunk(fp, "IDAT", zdata, out - zdata);
+  pngChunk(fp, "IEND", NULL, 0);
+  fclose(fp);
+  free(raw);
+  free(zdata);
+  printf("LCD contents written to %s\n", filename);
+  fflush(stdout);
+  }
+
+//---------------------------------------------------------------------------
+// Pin monitoring
+//---------------------------------------------------------------------------
+
+/** Called when the level on a port B pin changes
+ */
+static void pinChanged(struct avr_irq_t *irq, uint32_t value, void *param) {
+  int pin = (intptr_t)param;
+  uint8_t previous = g_levels[pin];
+  g_levels[pin] = value?1:0;
+  // UART start bit (only while the AVR is driving the pin)
+  if((pin==g_txPin)&&!g_rxBusy&&!g_txBusy&&previous&&!value&&(g_avr->data[DDRB_ADDR] & (1 << pin))) {
+    g_txBusy = true;
+    g_txBits = 0;
+    g_txData = 0;
+    avr_cycle_timer_register(g_avr, g_bitTime + (g_bitTime / 2), txSample, NULL);
+    }
+  // LCD
+  if((pin==g_lcdReset)&&!value)
+    lcdReset();
+  else if((pin==g_lcdSck)&&!previous&&value&&g_levels[g_lcdReset]) {
+    g_lcdShift = (g_lcdShift << 1) | g_levels[g_lcdMosi];
+    if(++g_lcdBits==8) {
+      g_lcdBits = 0;
+      if(g_levels[g_lcdCd])
+        lcdData(g_lcdShift);
+      else
+        lcdCommand(g_lcdShift);
+      }
+    }
+  }
+
+//---------------------------------------------------------------------------
+// Main program
+//---------------------------------------------------------------------------
+
+/** Signal handler
+ */
+static void onSignal(int sig) {
+  if(sig==SIGUSR1)
+    g_dump = 1;
+  else
+    g_quit = 1;
+  }
+
+/** Show usage information
+ */
+static int usage(const char *program) {
+  fprintf(stderr, "Usage: %s [-m mcu] [-f freq] [-b baud] [-t pin] [-r pin] [-L sck,mosi,cd,reset] [-o file] [-s scale] [-p link] firmware.elf\n", program);
+  return 1;
+  }
+
+/** Program entry point
+ */
+int main(int argc, char *argv[]) {
+  int opt;
+  while((opt = getopt(argc, argv, "m:f:b:t:r:L:o:s:p:"))!=-1) {
+    switch(opt) {
+      case 'm': g_mcu = optarg; break;
+      case 'f': g_frequency = strtoul(optarg, NULL, 0); break;
+      case 'b': g_baud = strtoul(optarg, NULL, 0); break;
+      case 't': g_txPin = atoi(optarg) & 0x07; break;
+      case 'r': g_rxPin = atoi(optarg) & 0x07; break;
+      case 'o': g_image = optarg; break;
+      case 's': g_scale = (atoi(optarg)>0)?atoi(optarg):1; break;
+      case 'p': g_link = optarg; break;
+      case 'L':
+        if(sscanf(optarg, "%d,%d,%d,%d", &g_lcdSck, &g_lcdMosi, &g_lcdCd, &g_lcdReset)!=4)
+          return usage(argv[0]);
+        g_lcdSck &= 0x07;
+        g_lcdMosi &= 0x07;
+        g_lcdCd &= 0x07;
+        g_lcdReset &= 0x07;
+        break;
+      default:
+        return usage(argv[0]);
+      }
+    }
+  if(optind>=argc)
+    return usage(argv[0]);
+  // Load the firmware
+  elf_firmware_t firmware;
+  memset(&firmware, 0, sizeof(firmware));
+  if(elf_read_firmware(argv[optind], &firmware)!=0) {
+    fprintf(stderr, "ERROR: Unable to load '%s'\n", argv[optind]);
+    return 1;
+    }
+  g_avr = avr_make_mcu_by_name(g_mcu);
+  if(g_avr==NULL) {
+    fprintf(stderr, "ERROR: Unknown MCU '%s'\n", g_mcu);
+    return 1;
+    }
+  avr_init(g_avr);
+  avr_load_firmware(g_avr, &firmware);
+  g_avr->frequency = g_frequency;
+  g_bitTime = g_frequency / g_baud;
+  // Attach to the port B pins, the UART line idles high
+  for(intptr_t pin=0; pin<8; pin++) {
+    g_pins[pin] = avr_io_getirq(g_avr, AVR_IOCTL_IOPORT_GETIRQ('B'), pin);
+    if(g_pins[pin]!=NULL)
+      avr_irq_register_notify(g_pins[pin], pinChanged, (void *)pin);
+    }
+  avr_raise_irq(g_pins[g_rxPin], 1);
+  lcdReset();
+  if(!ptyOpen()) {
+    fprintf(stderr, "ERROR: Unable to create pty\n");
+    return 1;
+    }
+  signal(SIGUSR1, onSignal);
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  // Run until the firmware stops (or we are interrupted)
+  int state = cpu_Running;
+  for(uint32_t count=0; !g_quit && (state!=cpu_Done) && (state!=cpu_Crashed); count++) {
+    state = avr_run(g_avr);
+    if((count % POLL_INTERVAL)==0)
+      rxPoll();
+    if(g_dump) {
+      g_dump = 0;
+      lcdSave(g_image);
+      }
+    }
+  if(state==cpu_Crashed)
+    fprintf(stderr, "ERROR: Firmware crashed at cycle %llu\n", (unsigned long long)g_avr->cycle);
+  lcdSave(g_image);
+  if(g_link!=NULL)
+    unlink(g_link);
+  close(g_pty);
+  return (state==cpu_Crashed)?1:0;
+  }
@@ -0,0 +1,185 @@
+#!/usr/bin/env python
+#----------------------------------------------------------------------------
+# 19-Oct-2026 ShaneG
+#
+# Summarise the build variants created by 'make variants'. Flash and RAM use
+# for each module is taken from the linker map of the main firmware and the
+# cycle counts from the benchmark results (if present).
+#----------------------------------------------------------------------------
+from sys import argv
+from os.path import exists, join, basename, splitext
+from glob import glob
+import re
+import json
+
+#----------------------------------------------------------------------------
+# Linker map processing
+#----------------------------------------------------------------------------
+
+# Section name prefixes and where they end up
+FLASH_SECTIONS = ( ".text", ".progmem", ".vectors", ".init", ".fini", ".trampolines", ".jumptables", ".ctors", ".dtors" )
+DATA_SECTIONS  = ( ".data", ".rodata" )
+RAM_SECTIONS   = ( ".bss", "COMMON", ".noinit" )
+
+# Input section with the address and size on the same line
+SECTION_LINE = re.compile(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+
+# Input section name on a line by itself (long names)
+SECTION_NAME = re.compile(r"^ (\S+)$")
+
+# Address and size following a long section name
+SECTION_INFO = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+
+""" Determine the module name for an object file
+"""
+def moduleName(filename):
+  filename = filename.strip()
+  if filename.find(".ltrans") >= 0:
+    return "(lto)"
+  if filename.find("(") >= 0:
+    # Archive member - group by library
+    return basename(filename[:filename.find("(")])
+  name = splitext(basename(filename))[0]
+  if name.startswith("crt"):
+    return "(startup)"
+  return name
+
+""" Add the size of a section to the module totals
+"""
+def addSection(modules, section, size, filename):
+  flash, ram = 0, 0
+  if section.startswith(FLASH_SECTIONS):
+    flash = size
+  elif section.startswith(DATA_SECTIONS):
+    flash, ram = size, size
+  elif section.startswith(RAM_SECTIONS):
+    ram = size
+  if (flash == 0) and (ram == 0):
+    return
+  name = moduleName(filename)
+  current = modules.get(name, (0, 0))
+  modules[name] = (current[0] + flash, current[1] + ram)
+
+""" Read a linker map and return a dictionary of (flash, ram) by module
+"""
+def readMap(filename):
+  modules = dict()
+  started = False
+  pending = None
+  for line in open(filename, "r"):
+    line = line.rstrip()
+    if not started:
+      started = line.startswith("Linker script and memory map")
+      continue
+    if pending is not None:
+      match = SECTION_INFO.match(line)
+      if match:
+        addSection(modules, pending, int(match.group(2), 16), match.group(3))
+      pending = None
+      continue
+    match = SECTION_LINE.match(line)
+    if match:
+      addSection(modules, match.group(1), int(match.group(3), 16), match.group(4))
+      continue
+    match = SECTION_NAME.match(line)
+    if match and not match.group(1).startswith("*"):
+      pending = match.group(1)
+  return modules
+
+""" Read the benchmark results for a variant
+"""
+def readBench(filename):
+  results = dict()
+  if exists(filename):
+    for result in json.load(open(filename, "r"))["results"]:
+      results[result["name"]] = result["avg"]
+  return results
+
+#----------------------------------------------------------------------------
+# Report generation
+#----------------------------------------------------------------------------
+
+""" Format a table with a left aligned first column
+"""
+def formatTable(headings, rows):
+  widths = [ len(heading) for heading in headings ]
+  for row in rows:
+    widths = [ max(width, len(cell)) for width, cell in zip(widths, row) ]
+  lines = list()
+  for row in [ headings ] + rows:
+    line = row[0].ljust(widths[0])
+    for width, cell in zip(widths[1:], row[1:]):
+      line = line + "  " + cell.rjust(width)
+    lines.append(line)
+  lines.insert(1, "-" * len(lines[0]))
+  return "\n".join(lines)
+
+""" Generate the report for a set of variants
+"""
+def createReport(directory, variants):
+  maps = dict()
+  bench = dict()
+  for variant in variants:
+    mapfiles = glob(join(directory, variant, "*.map"))
+    if len(mapfiles) == 0:
+      print "ERROR: No linker map for variant '%s'" % variant
+      exit(1)
+    maps[variant] = readMap(mapfiles[0])
+    bench[variant] = readBench(join(directory, variant, "bench.json"))
+  # Totals
+  rows = list()
+  for variant in variants:
+    flash = sum([ sizes[0] for sizes in maps[variant].values() ])
+    ram = sum([ sizes[1] for sizes in maps[variant].values() ])
+    rows.append([ variant, str(flash), str(ram) ])
+  report = "Totals (bytes)\n\n" + formatTable([ "Variant", "Flash", "RAM" ], rows) + "\n\n"
+  # Per module sizes (flash/RAM)
+  modules = set()
+  for variant in variants:
+    modules.update(maps[variant].keys())
+  rows = list()
+  for module in sorted(modules):
+    row = [ module ]
+    for variant in variants:
+      sizes = maps[variant].get(module, (0, 0))
+      row.append("%d/%d" % sizes)
+    rows.append(row)
+  report = report + "Flash/RAM by module (bytes)\n\n" + formatTable([ "Module" ] + variants, rows) + "\n"
+  # Benchmark results (average cycles)
+  regions = list()
+  for variant in variants:
+    for region in sorted(bench[variant].keys()):
+      if region not in regions:
+        regions.append(region)
+  if len(regions) > 0:
+    rows = list()
+    for region in regions:
+      row = [ region ]
+      for variant in variants:
+        if bench[variant].has_key(region):
+          row.append("%.1f" % bench[variant][region])
+        else:
+          row.append("-")
+      rows.append(row)
+    report = report + "\nAverage cycles\n\n" + formatTable([ "Benchmark" ] + variants, rows) + "\n"
+  return report
+
+#----------------------------------------------------------------------------
+# Main program
+#----------------------------------------------------------------------------
+
+USAGE = """
+Usage:
+     %s directory variant [variant ...]
+
+Where:
+  directory - the directory containing the variant builds.
+  variant   - the names of the variants to include in the report.
+"""
+
+if __name__ == "__main__":
+  # Have we been given command line arguments ?
+  if len(argv) <= 2:
+    print USAGE % argv[0]
+    exit(1)
+  print createReport(argv[1], argv[2:])
@@ -0,0 +1,517 @@
+#!/usr/bin/env python
+#----------------------------------------------------------------------------
+# 19-Oct-2026 ShaneG
+#
+# Polling daemon for nodes on a multi-drop bus (see include/bus.h). Each
+# node is polled at a regular interval with several requests outstanding at
+# once, each with its own timeout. The latest data and the latency and
+# throughput figures for every node are available on a Unix socket.
+#
+# The payload of every request and response starts with the address of the
+# sender and a sequence number so responses can be matched to requests:
+#
+#   request:  host_address sequence command...
+#   response: node_address sequence data...
+#
+# Use --simulate to run against a set of simulated nodes on a local pty
+# instead of real hardware.
+#----------------------------------------------------------------------------
+from sys import argv, stdout
+from time import time, sleep
+import os
+import tty
+import json
+import random
+import select
+import socket
+import threading
+from packet import packetEncode, packetDecode
+
+#--- Protocol constants
+FRAME_END = "\x00"
+BROADCAST = 0xFF
+
+#--- Default values
+DEFAULT_PORT     = "/dev/ttyUSB0"
+DEFAULT_SPEED    = 57600
+DEFAULT_HOST     = 0xFE      # Address of the host on the bus
+DEFAULT_NODES    = "1-16"
+DEFAULT_INTERVAL = 1.0       # Seconds between polls of each node
+DEFAULT_TIMEOUT  = 0.1       # Seconds to wait for each response
+DEFAULT_WINDOW   = 4         # Number of requests outstanding at once
+DEFAULT_COMMAND  = "P"       # Request payload (after the address and sequence)
+DEFAULT_SOCKET   = "/tmp/busd.sock"
+READ_SIZE        = 256       # Bytes to read from the stream at once
+
+#----------------------------------------------------------------------------
+# Bus framing
+#----------------------------------------------------------------------------
+
+""" Build a bus frame for the given address and payload
+"""
+def frameEncode(address, payload):
+  return FRAME_END + chr(address) + packetEncode(payload)
+
+class FrameDecoder:
+  """ Extract bus frames from a stream of data
+
+    Every frame on the bus is seen, including the ones we send.
+  """
+
+  def __init__(self):
+    self.buffer = ""
+    self.errors = 0
+
+  def feed(self, data):
+    """ Add received data and return a list of (address, payload) tuples
+    """
+    frames = list()
+    parts = (self.buffer + data).split(FRAME_END)
+    self.buffer = parts.pop()
+    for part in parts:
+      if len(part) == 0:
+        continue
+      payload = None
+      if len(part) > 1:
+        payload = packetDecode(part[1:])
+      if payload is None:
+        self.errors = self.errors + 1
+      else:
+        frames.append((ord(part[0]), payload))
+    return frames
+
+class PtyStream:
+  """ Minimal serial port replacement for a file descriptor (such as a pty)
+
+    Provides the read(), write(), fileno() and close() methods used by the
+    poller. Reads return whatever is available without waiting.
+  """
+
+  def __init__(self, fd):
+    self.fd = fd
+
+  def read(self, size):
+    if len(select.select([ self.fd ], [], [], 0)[0]) == 0:
+      return ""
+    return os.read(self.fd, size)
+
+  def write(self, data):
+    written = 0
+    while written < len(data):
+      written = written + os.write(self.fd, data[written:])
+    return written
+
+  def fileno(self):
+    return self.fd
+
+  def close(self):
+    os.close(self.fd)
+
+#----------------------------------------------------------------------------
+# Polling
+#----------------------------------------------------------------------------
+
+class Node:
+  """ State and statistics for a single node
+  """
+
+  def __init__(self, address, due):
+    self.address = address
+    self.due = due
+    self.sequence = 0
+    self.pending = dict() # Sequence number -> time sent
+    self.reset()
+
+  def reset(self):
+    """ Clear the statistics
+    """
+    self.sent = 0
+    self.received = 0
+    self.timeouts = 0
+    self.bytes = 0
+    self.latency = None
+    self.latencyMin = None
+    self.latencyMax = None
+    self.latencyTotal = 0.0
+    self.data = None
+    self.seen = None
+
+  def report(self, elapsed):
+    """ Get the statistics as a dictionary (latency in milliseconds)
+    """
+    result = {
+      "address": self.address,
+      "sent": self.sent,
+      "received": self.received,
+      "timeouts": self.timeouts,
+      "pending": len(self.pending),
+      "bytes": self.bytes,
+      "throughput": 0.0,
+      "latency": None,
+      "latency_min": None,
+      "latency_max": None,
+      "latency_avg": None,
+      }
+    if elapsed > 0:
+      result["throughput"] = round(self.bytes / elapsed, 1)
+    if self.received > 0:
+      result["latency"] = round(self.latency * 1000, 2)
+      result["latency_min"] = round(self.latencyMin * 1000, 2)
+      result["latency_max"] = round(self.latencyMax * 1000, 2)
+      result["latency_avg"] = round((self.latencyTotal / self.received) * 1000, 2)
+    return result
+
+class BusPoller:
+  """ Poll a set of nodes over a single stream
+  """
+
+  def __init__(self, host, addresses, interval, timeout, window, command):
+    self.host = host
+    self.interval = interval
+    self.timeout = timeout
+    self.window = window
+    self.request = command
+    self.stream = None
+    self.decoder = FrameDecoder()
+    # Spread the first polls over the interval
+    now = time()
+    self.nodes = dict()
+    for index, address in enumerate(addresses):
+      self.nodes[address] = Node(address, now + ((interval * index) / len(addresses)))
+    self.started = now
+
+  #--------------------------------------------------------------------------
+  # Connection
+  #--------------------------------------------------------------------------
+
+  def connect(self, port, speed = DEFAULT_SPEED):
+    """ Connect to the bus on the given serial port
+    """
+    try:
+      import serial
+    except:
+      print "Error: This tool requires the pySerial module. Please install it."
+      exit(1)
+    self.connectEx(serial.Serial(port = port, baudrate = speed, timeout = 0))
+
+  def connectEx(self, stream):
+    """ Connect to the bus using the provided stream
+
+      The stream needs read(), write(), fileno() and close() methods like a
+      serial.Serial instance and reads must not block (timeout = 0).
+    """
+    self.disconnect()
+    self.stream = stream
+
+  def connected(self):
+    """ Determine if we are connected to a bus
+    """
+    return self.stream is not None
+
+  def disconnect(self):
+    """ Close the stream (if open)
+    """
+    if self.connected():
+      try:
+        self.stream.close()
+      except:
+        pass # Do nothing
+    self.stream = None
+
+  #--------------------------------------------------------------------------
+  # Request handling
+  #--------------------------------------------------------------------------
+
+  def outstanding(self):
+    """ Get the number of requests waiting for a response
+    """
+    return sum([ len(node.pending) for node in self.nodes.values() ])
+
+  def service(self, now):
+    """ Expire old requests and send new ones
+
+      Returns the time the next request is due.
+    """
+    for node in self.nodes.values():
+      for sequence, sent in node.pending.items():
+        if (now - sent) >= self.timeout:
+          del node.pending[sequence]
+          node.timeouts = node.timeouts + 1
+    # Send requests to the nodes that are due (most overdue first)
+    for node in sorted(self.nodes.values(), key = lambda node: node.due):
+      if (node.due > now) or (self.outstanding() >= self.window):
+        break
+      node.sequence = (node.sequence + 1) & 0xFF
+      self.stream.write(frameEncode(node.address, chr(self.host) + chr(node.sequence) + self.request))
+      node.pending[node.sequence] = now
+      node.sent = node.sent + 1
+      node.due = max(node.due + self.interval, now)
+    return min([ node.due for node in self.nodes.values() ])
+
+  def receive(self, now):
+    """ Process data waiting on the stream
+    """
+    for address, payload in self.decoder.feed(self.stream.read(READ_SIZE)):
+      if (address <> self.host) or (len(payload) < 2):
+        continue
+      node = self.nodes.get(ord(payload[0]))
+      sequence = ord(payload[1])
+      if (node is None) or not node.pending.has_key(sequence):
+        continue
+      latency = now - node.pending[sequence]
+      del node.pending[sequence]
+      node.received = node.received + 1
+      node.bytes = node.bytes + len(payload) - 2
+      node.latency = latency
+      node.latencyTotal = node.latencyTotal + latency
+      node.latencyMin = latency if node.latencyMin is None else min(node.latencyMin, latency)
+      node.latencyMax = latency if node.latencyMax is None else max(node.latencyMax, latency)
+      node.data = payload[2:]
+      node.seen = now
+
+  #--------------------------------------------------------------------------
+  # Reporting
+  #--------------------------------------------------------------------------
+
+  def report(self):
+    """ Get the statistics for all nodes
+    """
+    elapsed = time() - self.started
+    return {
+      "uptime": round(elapsed, 1),
+      "errors": self.decoder.errors,
+      "nodes": [ self.nodes[address].report(elapsed) for address in sorted(self.nodes.keys()) ],
+      }
+
+  def data(self):
+    """ Get the latest data from each node (as hex) and its age in seconds
+    """
+    now = time()
+    result = dict()
+    for address, node in self.nodes.items():
+      if node.data is not None:
+        result[str(address)] = { "data": node.data.encode("hex"), "age": round(now - node.seen, 2) }
+    return result
+
+  def reset(self):
+    """ Clear all statistics
+    """
+    for node in self.nodes.values():
+      node.reset()
+    self.decoder.errors = 0
+    self.started = time()
+
+  def command(self, line):
+    """ Handle a request from a socket client and return the response
+    """
+    if line == "stats":
+      return self.report()
+    if line == "data":
+      return self.data()
+    if line == "reset":
+      self.reset()
+      return { "result": "ok" }
+    return { "error": "Unknown command '%s' (use stats, data or reset)" % line }
+
+  def showReport(self):
+    """ Display the statistics as a table
+    """
+    report = self.report()
+    print "%5s %7s %7s %7s %9s %9s %9s %9s" % ("Node", "Sent", "Recv", "Timeout", "Avg(ms)", "Min(ms)", "Max(ms)", "Bytes/s")
+    print "-" * 70
+    for node in report["nodes"]:
+      print "%5d %7d %7d %7d %9s %9s %9s %9.1f" % (node["address"], node["sent"], node["received"],
+        node["timeouts"], node["latency_avg"], node["latency_min"], node["latency_max"], node["throughput"])
+    print "%d invalid frames in %.1f seconds" % (report["errors"], report["uptime"])
+
+  #--------------------------------------------------------------------------
+  # Main loop
+  #--------------------------------------------------------------------------
+
+  def run(self, path):
+    """ Poll the nodes and serve the results on a Unix socket until interrupted
+    """
+    if os.path.exists(path):
+      os.unlink(path)
+    server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    server.bind(path)
+    server.listen(4)
+    clients = dict() # Socket -> partial line
+    try:
+      while True:
+        due = self.service(time())
+        wait = max(0.0, min(due - time(), self.timeout / 4))
+        readable = select.select([ self.stream, server ] + clients.keys(), [], [], wait)[0]
+        if self.stream in readable:
+          self.receive(time())
+        if server in readable:
+          client = server.accept()[0]
+          clients[client] = ""
+        for client in [ client for client in readable if clients.has_key(client) ]:
+          data = client.recv(READ_SIZE)
+          if len(data) == 0:
+            client.close()
+            del clients[client]
+            continue
+          lines = (clients[client] + data).split("\n")
+          clients[client] = lines.pop()
+          for line in lines:
+            client.sendall(json.dumps(self.command(line.strip())) + "\n")
+    finally:
+      for client in clients.keys():
+        client.close()
+      server.close()
+      os.unlink(path)
+
+#----------------------------------------------------------------------------
+# Simulated nodes
+#----------------------------------------------------------------------------
+
+class BusSimulator(threading.Thread):
+  """ Simulated nodes on the far end of a pty
+
+    Each node answers requests addressed to it with a counter and a fake
+    reading after a short random delay. A proportion of requests can be
+    ignored to exercise the timeout handling.
+  """
+
+  def __init__(self, addresses, loss = 0.0, delay = 0.01):
+    threading.Thread.__init__(self)
+    self.daemon = True
+    self.addresses = set(addresses)
+    self.loss = loss
+    self.delay = delay
+    self.counters = dict()
+    self.master, self.slave = os.openpty()
+    tty.setraw(self.slave)
+    self.port = os.ttyname(self.slave)
+
+  def stream(self):
+    """ Get the host side of the simulated bus
+    """
+    return PtyStream(self.master)
+
+  def run(self):
+    decoder = FrameDecoder()
+    while True:
+      try:
+        data = os.read(self.slave, READ_SIZE)
+      except OSError:
+        return # The host side has been closed
+      for address, payload in decoder.feed(data):
+        if (address not in self.addresses) or (len(payload) < 2) or (random.random() < self.loss):
+          continue
+        count = (self.counters.get(address, 0) + 1) & 0xFFFF
+        self.counters[address] = count
+        reading = random.randint(0, 1023)
+        sleep(random.uniform(0, self.delay))
+        response = chr(address) + payload[1] + chr(count >> 8) + chr(count & 0xFF) + chr(reading >> 8) + chr(reading & 0xFF)
+        try:
+          PtyStream(self.slave).write(frameEncode(ord(payload[0]), response))
+        except OSError:
+          return # The host side has been closed
+
+#----------------------------------------------------------------------------
+# Main program
+#----------------------------------------------------------------------------
+
+""" Parse a list of addresses (eg: '1-4,7,9')
+"""
+def parseNodes(text):
+  addresses = set()
+  for part in text.split(","):
+    if "-" in part:
+      first, last = part.split("-")
+      addresses.update(range(int(first, 0), int(last, 0) + 1))
+    else:
+      addresses.add(int(part, 0))
+  for address in addresses:
+    if (address < 1) or (address >= BROADCAST):
+      raise ValueError()
+  return sorted(addresses)
+
+USAGE = """
+Usage:
+     %s [options]
+
+Options:
+  -p,--port name      Serial port connected to the bus (default %s).
+  -s,--speed baud     Serial port speed (default %d).
+  -n,--nodes list     Node addresses to poll, eg: 1-4,7 (default %s).
+  -a,--address addr   Address of the host on the bus (default %d).
+  -i,--interval secs  Time between polls of each node (default %.1f).
+  -t,--timeout secs   Time to wait for each response (default %.2f).
+  -w,--window count   Requests outstanding at once (default %d).
+  -c,--command hex    Request payload after the address and sequence
+                      (default '%s').
+  -u,--socket path    Unix socket for results (default %s).
+  --simulate loss     Poll simulated nodes on a local pty instead of the
+                      serial port, ignoring the given fraction of requests.
+
+Connect to the socket and send 'stats', 'data' or 'reset' (one per line) to
+get the statistics, the latest data from each node or to clear the
+statistics. Each response is a single line of JSON. The statistics are
+displayed when the daemon is interrupted.
+"""
+
+if __name__ == "__main__":
+  port = DEFAULT_PORT
+  speed = DEFAULT_SPEED
+  nodes = DEFAULT_NODES
+  host = DEFAULT_HOST
+  interval = DEFAULT_INTERVAL
+  timeout = DEFAULT_TIMEOUT
+  window = DEFAULT_WINDOW
+  command = DEFAULT_COMMAND
+  path = DEFAULT_SOCKET
+  simulate = None
+  index = 1
+  try:
+    while index < len(argv):
+      arg, value = argv[index], argv[index + 1]
+      if arg in ("-p", "--port"):
+        port = value
+      elif arg in ("-s", "--speed"):
+        speed = int(value)
+      elif arg in ("-n", "--nodes"):
+        nodes = value
+      elif arg in ("-a", "--address"):
+        host = int(value, 0)
+      elif arg in ("-i", "--interval"):
+        interval = float(value)
+      elif arg in ("-t", "--timeout"):
+        timeout = float(value)
+      elif arg in ("-w", "--window"):
+        window = int(value)
+      elif arg in ("-c", "--command"):
+        command = value.decode("hex")
+      elif arg in ("-u", "--socket"):
+        path = value
+      elif arg == "--simulate":
+        simulate = float(value)
+      else:
+        raise ValueError()
+      index = index + 2
+    addresses = parseNodes(nodes)
+  except (IndexError, ValueError, TypeError):
+    print USAGE % (argv[0], DEFAULT_PORT, DEFAULT_SPEED, DEFAULT_NODES, DEFAULT_HOST,
+      DEFAULT_INTERVAL, DEFAULT_TIMEOUT, DEFAULT_WINDOW, DEFAULT_COMMAND.encode("hex"), DEFAULT_SOCKET)
+    exit(1)
+  poller = BusPoller(host, addresses, interval, timeout, window, command)
+  if simulate is not None:
+    simulator = BusSimulator(addresses, simulate)
+    simulator.start()
+    print "Simulating %d nodes on %s" % (len(addresses), simulator.port)
+    poller.connectEx(simulator.stream())
+  else:
+    poller.connect(port, speed)
+  print "Polling %d nodes, results on %s" % (len(addresses), path)
+  stdout.flush()
+  try:
+    poller.run(path)
+  except KeyboardInterrupt:
+    pass
+  poller.disconnect()
+  if simulate is not None:
+    simulator.join(1.0)
+  poller.showReport()
@@ -111,9 +111,12 @@ def processImage(filename, oncolor):
   # Start processing the file
   return imageToBits(image, oncolor)
 
-""" Create a C file from the bits in the image
+""" Convert the image bits into a list of 8 pixel vertical strips
+
+  Returns the padded height and the list of column bytes, one row of strips
+  at a time.
 """
-def createCode(name, width, height, bits):
+def imageToColumns(width, height, bits):
   # Pad the image to a height that is a multiple of 8
   padding = "0" * width
   top = True
@@ -124,8 +127,8 @@ def createCode(name, width, height, bits):
       bits = bits + padding
     height = height + 1
     top = not top
-  # Now generate the values for each byte starting with the size
-  results = [ ((int(height / 8) - 1) << 6) | (width - 1) ]
+  # Now generate the values for each byte
+  results = list()
   for y in range(height / 8):
     for x in range(width):
       value = 0x00
@@ -134,7 +137,11 @@ def createCode(name, width, height, bits):
         if bits[((((y + 1) * 8) - bit - 1) * width) + x] == '1':
           value = value | 0x01
       results.append(value)
-  # Generate the output
+  return height, results
+
+""" Generate the C array definition for a list of byte values
+"""
+def createArray(name, results):
   output = "const uint8_t IMAGE_%s[] PROGMEM = {\n" % name
   results = [ "0x%02x" % x for x in results ]
   while len(results) > 0:
@@ -143,6 +150,66 @@ def createCode(name, width, height, bits):
   output = output + "  };\n"
   return output
 
+""" Create a C file from the bits in the image
+"""
+def createCode(name, width, height, bits):
+  height, columns = imageToColumns(width, height, bits)
+  # Start with the packed size
+  results = [ ((int(height / 8) - 1) << 6) | (width - 1) ] + columns
+  return createArray(name, results)
+
+#----------------------------------------------------------------------------
+# Run length compression
+#
+# Compressed images are decoded by lcdImageRleP(). The data is a sequence of
+# packets, each starting with a control byte -
+#
+#   0x00 - 0x7F: The next (control + 1) bytes are copied as is.
+#   0x80 - 0xFF: The next byte is repeated ((control & 0x7F) + 3) times.
+#----------------------------------------------------------------------------
+
+RLE_MIN_RUN = 3
+RLE_MAX_RUN = 0x7F + RLE_MIN_RUN
+RLE_MAX_LITERAL = 0x80
+
+""" Compress a list of byte values
+"""
+def compressRLE(data):
+  results = list()
+  literal = list()
+  index = 0
+  while index < len(data):
+    # See how long the run starting here is
+    run = 1
+    while ((index + run) < len(data)) and (data[index + run] == data[index]) and (run < RLE_MAX_RUN):
+      run = run + 1
+    if run >= RLE_MIN_RUN:
+      # Flush any pending literals and add the run
+      if len(literal) > 0:
+        results = results + [ len(literal) - 1 ] + literal
+        literal = list()
+      results = results + [ 0x80 | (run - RLE_MIN_RUN), data[index] ]
+      index = index + run
+    else:
+      literal.append(data[index])
+      index = index + 1
+      if len(literal) == RLE_MAX_LITERAL:
+        results = results + [ len(literal) - 1 ] + literal
+        literal = list()
+  # Add any remaining literals
+  if len(literal) > 0:
+    results = results + [ len(literal) - 1 ] + literal
+  return results
+
+""" Create a C file with a compressed version of the image
+"""
+def createCodeRLE(name, width, height, bits):
+  height, columns = imageToColumns(width, height, bits)
+  # Height (in rows) and width followed by the compressed data
+  results = [ int(height / 8), width ] + compressRLE(columns)
+  output = "// %d bytes compressed to %d\n" % (len(columns) + 1, len(results))
+  return output + createArray(name, results)
+
 #----------------------------------------------------------------------------
 # Main program
 #----------------------------------------------------------------------------
@@ -167,6 +234,11 @@ Options:
       of the foreground color. Without the option any white pixels are set as
       the foreground, with the option applied black pixels are considered the
       foreground.
+
+    --rle
+
+      Generate a run length compressed image for use with lcdImageRleP(). This
+      also allows images up to the full size of the display (84 x 48).
 """
 
 if __name__ == "__main__":
@@ -176,11 +248,17 @@ if __name__ == "__main__":
     exit(1)
   # Collect options
   oncolor = 255
+  generate = createCode
   index = 1
   while argv[index].startswith("--"):
     if argv[index] == "--invert":
       oncolor = 0
       index = index + 1
+    elif argv[index] == "--rle":
+      generate = createCodeRLE
+      MAX_IMAGE_WIDTH = 84
+      MAX_IMAGE_HEIGHT = 48
+      index = index + 1
     else:
       print "ERROR: Unrecognised option '%s'" % argv[index]
       exit(1)
@@ -188,5 +266,5 @@ if __name__ == "__main__":
   for filename in argv[index:]:
     width, height, bits = processImage(filename, oncolor)
     symbol = splitext(split(filename)[1])[0].upper()
-    print createCode(symbol, width, height, bits)
+    print generate(symbol, width, height, bits)
 
@@ -54,6 +54,54 @@ def endProgress():
   stdout.write('\n')
   stdout.flush()
 
+#----------------------------------------------------------------------------
+# CRC calculation (matches shared/crc16.c in the firmware)
+#----------------------------------------------------------------------------
+
+# Lookup table used by the firmware (one entry per nybble)
+CRC_LOOKUP = (
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x0881, 0x2991, 0x4AA1, 0x6BB1, 0x8CC1, 0xADD1, 0xCEE1, 0xEFF1
+  )
+
+def crcInit():
+  """ Get the initial CRC value
+
+    @return the initial CRC value.
+  """
+  return 0xFFFF
+
+def crcByte(crc, data):
+  """ Add a byte to an ongoing CRC calculation
+
+    This uses the same lookup table as the firmware so the results will
+    match those calculated on the device.
+
+    @param crc the current CRC value
+    @param data the data byte to add to the calculation
+
+    @return the updated CRC value.
+  """
+  work = (crc >> 12) ^ (data >> 4)
+  crc = ((crc << 4) & 0xFFFF) ^ CRC_LOOKUP[work]
+  work = (crc >> 12) ^ (data & 0x0F)
+  crc = ((crc << 4) & 0xFFFF) ^ CRC_LOOKUP[work]
+  return crc
+
+def crcData(crc, data):
+  """ Add a sequence of bytes to an ongoing CRC calculation
+
+    @param crc the current CRC value
+    @param data a sequence of byte values (or a string)
+
+    @return the updated CRC value.
+  """
+  for val in data:
+    if isinstance(val, str):
+      val = ord(val)
+    crc = crcByte(crc, val)
+  return crc
+
 # Testing
 if __name__ == "__main__":
   # First test, no title
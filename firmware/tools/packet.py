@@ -0,0 +1,203 @@
+#!/usr/bin/env python
+#----------------------------------------------------------------------------
+# 19-Oct-2026 ShaneG
+#
+# Host side of the packet protocol (see include/packet.h). Packets are the
+# payload followed by a CRC-16/CCITT (high byte first), COBS encoded and
+# terminated with a zero byte. When run directly this displays packets
+# received from a serial port and can send a packet to the device.
+#----------------------------------------------------------------------------
+from sys import argv, stdout
+
+#--- Protocol constants
+PACKET_END = "\x00"
+COBS_RUN   = 254 # Longest run of data bytes in a block
+MAX_SIZE   = 253 # Largest payload the firmware can send
+CRC_POLY   = 0x1021
+CRC_INIT   = 0xFFFF
+
+#--- Default values
+DEFAULT_PORT  = "/dev/ttyUSB0"
+DEFAULT_SPEED = 57600
+
+#----------------------------------------------------------------------------
+# COBS encoding
+#----------------------------------------------------------------------------
+
+""" Encode a string with COBS
+
+  The result contains no zero bytes. The terminating zero is not added.
+"""
+def cobsEncode(data):
+  result = ""
+  pos = 0
+  while True:
+    end = data.find("\x00", pos, pos + COBS_RUN)
+    if end < 0:
+      end = min(len(data), pos + COBS_RUN)
+    run = end - pos
+    result = result + chr(run + 1) + data[pos:end]
+    pos = end
+    if pos >= len(data):
+      return result
+    # Skip the zero (it is implied by the code)
+    if run < COBS_RUN:
+      pos = pos + 1
+
+""" Decode a COBS encoded string (without the terminating zero)
+
+  Returns None if the encoding is not valid.
+"""
+def cobsDecode(data):
+  result = ""
+  pos = 0
+  while pos < len(data):
+    code = ord(data[pos])
+    if (code == 0) or ((pos + code) > len(data)):
+      return None
+    result = result + data[pos + 1:pos + code]
+    pos = pos + code
+    if (code <= COBS_RUN) and (pos < len(data)):
+      result = result + "\x00"
+  return result
+
+#----------------------------------------------------------------------------
+# Packet encoding
+#----------------------------------------------------------------------------
+
+""" Calculate the CRC-16/CCITT of a string
+
+  This is not the mbutil CRC - the firmware calculates it bit by bit so
+  every single byte error is detected.
+"""
+def packetCrc(data):
+  crc = CRC_INIT
+  for ch in data:
+    crc = crc ^ (ord(ch) << 8)
+    for bit in range(8):
+      if crc & 0x8000:
+        crc = ((crc << 1) ^ CRC_POLY) & 0xFFFF
+      else:
+        crc = (crc << 1) & 0xFFFF
+  return crc
+
+""" Build a packet from a payload string
+
+  Returns the encoded packet including the terminating zero.
+"""
+def packetEncode(payload):
+  crc = packetCrc(payload)
+  return cobsEncode(payload + chr(crc >> 8) + chr(crc & 0xFF)) + PACKET_END
+
+""" Extract the payload from a single frame (without the terminating zero)
+
+  Returns None if the frame is not valid.
+"""
+def packetDecode(frame):
+  data = cobsDecode(frame)
+  if (data is None) or (len(data) < 2):
+    return None
+  crc = (ord(data[-2]) << 8) | ord(data[-1])
+  if packetCrc(data[:-2]) <> crc:
+    return None
+  return data[:-2]
+
+class PacketDecoder:
+  """ Extract packets from a stream of data
+
+    Data can be added in pieces of any size, partial frames are kept until
+    the rest of the data arrives.
+  """
+
+  def __init__(self):
+    self.buffer = ""
+    self.errors = 0
+
+  def feed(self, data):
+    """ Add received data and return a list of complete packet payloads
+    """
+    packets = list()
+    frames = (self.buffer + data).split(PACKET_END)
+    self.buffer = frames.pop()
+    for frame in frames:
+      if len(frame) == 0:
+        continue
+      payload = packetDecode(frame)
+      if payload is None:
+        self.errors = self.errors + 1
+      else:
+        packets.append(payload)
+    return packets
+
+#----------------------------------------------------------------------------
+# Main program
+#----------------------------------------------------------------------------
+
+""" Format a payload for display
+"""
+def showPacket(payload):
+  print "[%3d] %s" % (len(payload), " ".join([ "%02X" % ord(ch) for ch in payload ]))
+  stdout.flush()
+
+USAGE = """
+Usage:
+     %s [options]
+
+Options:
+  -p,--port name    Serial port to use (default %s).
+  -s,--speed baud   Serial port speed (default %d).
+  -x,--send hex     Send a packet with the given payload (hex digits) first.
+  -f,--file name    Decode packets from a raw capture file instead.
+
+Displays the payload of each packet received in hex until interrupted. The
+number of invalid packets is shown at the end.
+"""
+
+if __name__ == "__main__":
+  port = DEFAULT_PORT
+  speed = DEFAULT_SPEED
+  send = None
+  filename = None
+  index = 1
+  try:
+    while index < len(argv):
+      arg = argv[index]
+      if arg in ("-p", "--port"):
+        port = argv[index + 1]
+      elif arg in ("-s", "--speed"):
+        speed = int(argv[index + 1])
+      elif arg in ("-x", "--send"):
+        send = argv[index + 1].decode("hex")
+        if len(send) > MAX_SIZE:
+          raise ValueError()
+      elif arg in ("-f", "--file"):
+        filename = argv[index + 1]
+      else:
+        raise ValueError()
+      index = index + 2
+  except (IndexError, ValueError, TypeError):
+    print USAGE % (argv[0], DEFAULT_PORT, DEFAULT_SPEED)
+    exit(1)
+  decoder = PacketDecoder()
+  # Process a capture file
+  if filename is not None:
+    for payload in decoder.feed(open(filename, "rb").read()):
+      showPacket(payload)
+    print "%d invalid packets" % decoder.errors
+    exit(0)
+  # Talk to the device
+  try:
+    import serial
+  except:
+    print "Error: This tool requires the pySerial module. Please install it."
+    exit(1)
+  source = serial.Serial(port = port, baudrate = speed, timeout = 0.2)
+  if send is not None:
+    source.write(packetEncode(send))
+  try:
+    while True:
+      for payload in decoder.feed(source.read(256)):
+        showPacket(payload)
+  except KeyboardInterrupt:
+    source.close()
+  print "%d invalid packets" % decoder.errors
@@ -0,0 +1,217 @@
+#!/usr/bin/env python
+#----------------------------------------------------------------------------
+# 19-Oct-2026 ShaneG
+#
+# Estimate the worst case stack use of a firmware image. Frame sizes come
+# from the .su files generated by gcc with -fstack-usage and the call graph
+# is taken from the disassembly of the linked ELF file. The deepest call
+# chain is reported for main() and for each interrupt handler.
+#----------------------------------------------------------------------------
+from sys import argv
+from subprocess import Popen, PIPE
+import re
+
+#--- Default values
+DEFAULT_OBJDUMP  = "avr-objdump"
+DEFAULT_NM       = "avr-nm"
+DEFAULT_RAMSTART = 0x60
+DEFAULT_RAMSIZE  = 512
+RETURN_SIZE      = 2 # Bytes pushed by a call (or an interrupt)
+
+# Function heading in the disassembly (eg: '0000003c <main>:')
+FUNCTION = re.compile(r"^[0-9a-fA-F]+ <([^>]+)>:$")
+
+# Instruction with a symbolic target (eg: 'rcall .+8 ; 0x48 <ticks>')
+BRANCH = re.compile(r"\s(r?call|r?jmp)\s.*;\s*0x[0-9a-fA-F]+ <([^>+]+)>")
+
+# Indirect calls and jumps
+INDIRECT = re.compile(r"\s(e?icall|e?ijmp)\b")
+
+# Interrupt handlers
+VECTOR = re.compile(r"^__vector_\d+$")
+
+#----------------------------------------------------------------------------
+# Input processing
+#----------------------------------------------------------------------------
+
+""" Run a command and return the output as a list of lines
+"""
+def runCommand(command):
+  process = Popen(command, stdout = PIPE)
+  output = process.communicate()[0]
+  if process.returncode <> 0:
+    print "ERROR: Command '%s' failed." % " ".join(command)
+    exit(1)
+  return output.splitlines()
+
+""" Read the frame sizes from a set of .su files
+
+  Each line has the form 'file:line:column:function<TAB>size<TAB>type'.
+"""
+def readFrames(filenames):
+  frames = dict()
+  for filename in filenames:
+    try:
+      lines = open(filename, "r").readlines()
+    except IOError:
+      print "WARNING: Unable to read '%s'" % filename
+      continue
+    for line in lines:
+      parts = line.strip().split("\t")
+      if len(parts) < 3:
+        continue
+      name = parts[0].split(":")[-1]
+      frames[name] = (int(parts[1]), parts[2])
+  return frames
+
+""" Build the call graph from the disassembly
+
+  Returns a dictionary mapping each function to a tuple containing a set of
+  (callee, extra) pairs and a flag indicating if indirect calls are made.
+  The extra value is the space used by the call itself (nothing for a tail
+  call made with a jump).
+"""
+def readCalls(objdump, elffile):
+  calls = dict()
+  current = None
+  for line in runCommand([ objdump, "-d", elffile ]):
+    match = FUNCTION.match(line.strip())
+    if match:
+      current = match.group(1)
+      calls[current] = (set(), False)
+      continue
+    if current is None:
+      continue
+    match = BRANCH.search(line)
+    if match and (match.group(2) <> current):
+      extra = 0
+      if match.group(1).endswith("call"):
+        extra = RETURN_SIZE
+      calls[current][0].add((match.group(2), extra))
+    elif INDIRECT.search(line):
+      calls[current] = (calls[current][0], True)
+  return calls
+
+""" Get the end address of the static data from the symbol table
+"""
+def readDataEnd(nm, elffile):
+  for line in runCommand([ nm, elffile ]):
+    parts = line.split()
+    if (len(parts) == 3) and (parts[2] == "_end"):
+      return int(parts[0], 16) & 0xFFFF
+  return None
+
+#----------------------------------------------------------------------------
+# Analysis
+#----------------------------------------------------------------------------
+
+class StackAnalysis:
+  """ Calculate the deepest call chain from a function
+  """
+
+  def __init__(self, frames, calls):
+    self.frames = frames
+    self.calls = calls
+    self.results = dict()
+    self.warnings = set()
+
+  def depth(self, function, active = None):
+    """ Get the worst case stack depth (and the call chain) for a function
+    """
+    if self.results.has_key(function):
+      return self.results[function]
+    if active is None:
+      active = list()
+    frame = 0
+    if self.frames.has_key(function):
+      frame = self.frames[function][0]
+      if self.frames[function][1] <> "static":
+        self.warnings.add("%s has a %s frame size" % (function, self.frames[function][1]))
+    elif self.calls.has_key(function) and not function.startswith("__vector"):
+      self.warnings.add("%s has no stack information" % function)
+    callees, indirect = self.calls.get(function, (set(), False))
+    if indirect:
+      self.warnings.add("%s makes indirect calls (not followed)" % function)
+    active.append(function)
+    deepest, chain = 0, list()
+    for callee, extra in callees:
+      if callee in active:
+        self.warnings.add("%s is recursive (depth is not bounded)" % callee)
+        continue
+      size, path = self.depth(callee, active)
+      if (size + extra) > deepest:
+        deepest, chain = size + extra, path
+    active.pop()
+    self.results[function] = (frame + deepest, [ function ] + chain)
+    return self.results[function]
+
+#----------------------------------------------------------------------------
+# Main program
+#----------------------------------------------------------------------------
+
+USAGE = """
+Usage:
+     %s [options] firmware.elf file.su [file.su ...]
+
+Options:
+  --objdump name   Name of the objdump program (default %s).
+  --nm name        Name of the nm program (default %s).
+  --ram size       Size of RAM in bytes (default %d).
+  --ramstart addr  Address of the first byte of RAM (default 0x%02X).
+
+Shows the deepest stack use for main() and each interrupt handler and an
+estimate of the free RAM left in the worst case (main() interrupted by the
+deepest handler). Functions without stack information (library and
+assembly code) are assumed to use no stack beyond the return address.
+"""
+
+if __name__ == "__main__":
+  objdump = DEFAULT_OBJDUMP
+  nm = DEFAULT_NM
+  ramsize = DEFAULT_RAMSIZE
+  ramstart = DEFAULT_RAMSTART
+  index = 1
+  try:
+    while argv[index].startswith("--"):
+      if argv[index] == "--objdump":
+        objdump = argv[index + 1]
+      elif argv[index] == "--nm":
+        nm = argv[index + 1]
+      elif argv[index] == "--ram":
+        ramsize = int(argv[index + 1], 0)
+      elif argv[index] == "--ramstart":
+        ramstart = int(argv[index + 1], 0)
+      else:
+        raise ValueError()
+      index = index + 2
+    elffile = argv[index]
+    sufiles = argv[index + 1:]
+  except (IndexError, ValueError):
+    print USAGE % (argv[0], DEFAULT_OBJDUMP, DEFAULT_NM, DEFAULT_RAMSIZE, DEFAULT_RAMSTART)
+    exit(1)
+  analysis = StackAnalysis(readFrames(sufiles), readCalls(objdump, elffile))
+  roots = [ "main" ] + sorted([ name for name in analysis.calls.keys() if VECTOR.match(name) ])
+  # Show the results for each entry point
+  print "%-20s %6s  %s" % ("Entry", "Bytes", "Deepest call chain")
+  print "-" * 60
+  worstIsr = 0
+  for root in roots:
+    if not analysis.calls.has_key(root):
+      continue
+    size, chain = analysis.depth(root)
+    if root <> "main":
+      # Interrupts push the return address as well
+      size = size + RETURN_SIZE
+      worstIsr = max(worstIsr, size)
+    print "%-20s %6d  %s" % (root, size, " > ".join(chain))
+  # Summary
+  mainSize = analysis.depth("main")[0] if analysis.calls.has_key("main") else 0
+  total = mainSize + worstIsr
+  print
+  print "Worst case stack (main + deepest handler): %d bytes" % total
+  dataEnd = readDataEnd(nm, elffile)
+  if dataEnd is not None:
+    static = dataEnd - ramstart
+    print "Static data: %d bytes, free RAM in the worst case: %d bytes" % (static, ramsize - static - total)
+  for warning in sorted(analysis.warnings):
+    print "WARNING: " + warning
@@ -0,0 +1,179 @@
+#!/usr/bin/env python
+#----------------------------------------------------------------------------
+# 19-Oct-2026 ShaneG
+#
+# Display event trace records sent by traceDrain() as a timeline. The data
+# can be read directly from a serial port or from a file containing a raw
+# capture of the serial data.
+#----------------------------------------------------------------------------
+from sys import argv, stdout
+from mbutil import crcInit, crcData
+
+#--- Frame format constants
+FRAME_SYNC    = "TR"
+HEADER_SIZE   = 4  # Sync, count and dropped
+RECORD_SIZE   = 4  # Id, value and time stamp
+TRAILER_SIZE  = 2  # CRC
+
+#--- Default values
+DEFAULT_PORT   = "/dev/ttyUSB0"
+DEFAULT_SPEED  = 57600
+DEFAULT_CPU    = 8000000
+DEFAULT_CYCLES = 8        # CPU cycles per time stamp count (TICKS_FINE_CYCLES)
+LANE_WIDTH     = 6        # Width of each column in the timeline
+
+#----------------------------------------------------------------------------
+# Frame decoding
+#----------------------------------------------------------------------------
+
+""" Extract complete frames from a buffer
+
+  Returns a list of (dropped, records) tuples for each valid frame and the
+  unused portion of the buffer. Each record is an (id, value, stamp) tuple.
+  Data that is not part of a valid frame is skipped.
+"""
+def decodeFrames(data):
+  frames = list()
+  while True:
+    start = data.find(FRAME_SYNC)
+    if start < 0:
+      # Keep a possible partial sync sequence
+      return frames, data[-1:]
+    data = data[start:]
+    if len(data) < HEADER_SIZE:
+      return frames, data
+    count = ord(data[2])
+    size = HEADER_SIZE + (count * RECORD_SIZE) + TRAILER_SIZE
+    if len(data) < size:
+      return frames, data
+    crc = (ord(data[size - 2]) << 8) | ord(data[size - 1])
+    if crcData(crcInit(), data[2:size - TRAILER_SIZE]) <> crc:
+      # Not a valid frame, skip the sync and keep looking
+      data = data[1:]
+      continue
+    records = list()
+    for index in range(HEADER_SIZE, size - TRAILER_SIZE, RECORD_SIZE):
+      stamp = ord(data[index + 2]) | (ord(data[index + 3]) << 8)
+      records.append((ord(data[index]), ord(data[index + 1]), stamp))
+    frames.append((ord(data[3]), records))
+    data = data[size:]
+
+#----------------------------------------------------------------------------
+# Timeline display
+#----------------------------------------------------------------------------
+
+class Timeline:
+  """ Convert records to absolute time and display them
+
+    The 16 bit time stamps wrap around (every 65ms at 8MHz) so gaps longer
+    than that between records cannot be detected.
+  """
+
+  def __init__(self, cpu, cycles):
+    self.scale = (cycles * 1000000.0) / cpu
+    self.lanes = list()
+    self.last = None
+    self.time = 0
+
+  def show(self, dropped, records):
+    """ Display the records from a single frame
+    """
+    if dropped > 0:
+      print "*** %d records dropped ***" % dropped
+    # Add any new lanes (and show the heading again)
+    lanes = sorted(set([ record[0] for record in records ]) - set(self.lanes))
+    if len(lanes) > 0:
+      self.lanes.extend(lanes)
+      heading = "%12s %10s  " % ("Time (us)", "Delta")
+      for lane in self.lanes:
+        heading = heading + ("%d" % lane).center(LANE_WIDTH)
+      print heading
+      print "-" * len(heading)
+    for id, value, stamp in records:
+      delta = 0
+      if self.last is not None:
+        delta = (stamp - self.last) & 0xFFFF
+      self.last = stamp
+      self.time = self.time + delta
+      line = "%12.1f %10.1f  " % (self.time * self.scale, delta * self.scale)
+      for lane in self.lanes:
+        if lane == id:
+          line = line + ("%02X" % value).center(LANE_WIDTH)
+        else:
+          line = line + "|".center(LANE_WIDTH)
+      print line.rstrip()
+    stdout.flush()
+
+#----------------------------------------------------------------------------
+# Main program
+#----------------------------------------------------------------------------
+
+USAGE = """
+Usage:
+     %s [options] [filename]
+
+Options:
+  -p,--port name    Read from the named serial port (default %s).
+  -s,--speed baud   Serial port speed (default %d).
+  -c,--cpu freq     CPU frequency of the device (default %d).
+  --cycles count    CPU cycles per time stamp count (default %d).
+
+If a filename is given the trace is read from the file (a raw capture of the
+serial data) instead of the serial port. Each event id is displayed in its
+own column with the event value shown in hex.
+"""
+
+if __name__ == "__main__":
+  port = DEFAULT_PORT
+  speed = DEFAULT_SPEED
+  cpu = DEFAULT_CPU
+  cycles = DEFAULT_CYCLES
+  filename = None
+  index = 1
+  try:
+    while index < len(argv):
+      arg = argv[index]
+      if arg in ("-p", "--port"):
+        port = argv[index + 1]
+        index = index + 2
+      elif arg in ("-s", "--speed"):
+        speed = int(argv[index + 1])
+        index = index + 2
+      elif arg in ("-c", "--cpu"):
+        cpu = int(argv[index + 1])
+        index = index + 2
+      elif arg == "--cycles":
+        cycles = int(argv[index + 1])
+        index = index + 2
+      elif arg.startswith("-"):
+        print USAGE % (argv[0], DEFAULT_PORT, DEFAULT_SPEED, DEFAULT_CPU, DEFAULT_CYCLES)
+        exit(1)
+      else:
+        filename = arg
+        index = index + 1
+  except (IndexError, ValueError):
+    print USAGE % (argv[0], DEFAULT_PORT, DEFAULT_SPEED, DEFAULT_CPU, DEFAULT_CYCLES)
+    exit(1)
+  timeline = Timeline(cpu, cycles)
+  # Process a capture file
+  if filename is not None:
+    frames, data = decodeFrames(open(filename, "rb").read())
+    for dropped, records in frames:
+      timeline.show(dropped, records)
+    exit(0)
+  # Read from the serial port until interrupted
+  try:
+    import serial
+  except:
+    print "Error: This tool requires the pySerial module. Please install it."
+    exit(1)
+  source = serial.Serial(port = port, baudrate = speed, timeout = 0.2)
+  data = ""
+  try:
+    while True:
+      data = data + source.read(256)
+      frames, data = decodeFrames(data)
+      for dropped, records in frames:
+        timeline.show(dropped, records)
+  except KeyboardInterrupt:
+    source.close()